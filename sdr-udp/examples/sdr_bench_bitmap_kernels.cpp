@@ -0,0 +1,290 @@
+// Bitmap kernel benchmark: the bit-at-a-time loops SR and EC used before
+// sdr_bitmap_kernels.h vs. the kernels with the scalar and AVX2 dispatch, on chunk
+// bitmaps with 1%, 10% and 50% of chunks missing (independent random losses).
+//   feedback: SR receiver ACK/NACK construction (cumulative ACK, first gap, 4 gaps, 512-chunk window)
+//   gaps:     every run of missing chunks (EC NACK gap list, uncapped)
+//   popcount: chunks present
+//   apply:    sender marking acked chunks from an 8-word feedback bitmap
+// Usage: sdr_bench_bitmap_kernels [iterations]
+#include "sdr_bitmap_kernels.h"
+#include "sdr_backend.h"
+#include "sdr_frontend.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <algorithm>
+
+using namespace sdr;
+
+namespace {
+
+struct Feedback {
+    uint32_t cumulative{UINT32_MAX};
+    uint32_t missing_start{0};
+    uint32_t missing_len{0};
+    uint64_t words[8]{};
+    uint32_t num_gaps{0};
+    uint32_t gap_start[4]{};
+    uint32_t gap_len[4]{};
+
+    bool operator==(const Feedback& o) const {
+        if (cumulative != o.cumulative || missing_start != o.missing_start ||
+            missing_len != o.missing_len || num_gaps != o.num_gaps) {
+            return false;
+        }
+        for (uint32_t i = 0; i < 8; ++i) {
+            if (words[i] != o.words[i]) return false;
+        }
+        for (uint32_t i = 0; i < num_gaps; ++i) {
+            if (gap_start[i] != o.gap_start[i] || gap_len[i] != o.gap_len[i]) return false;
+        }
+        return true;
+    }
+};
+
+// SRReceiver::pump before the kernels: three walks over is_chunk_complete
+Feedback legacy_feedback(const FrontendBitmap& fb, uint32_t total_chunks) {
+    Feedback out;
+    int64_t cumulative_idx = -1;
+    while (static_cast<uint32_t>(cumulative_idx + 1) < total_chunks &&
+           fb.is_chunk_complete(static_cast<uint32_t>(cumulative_idx + 1))) {
+        cumulative_idx++;
+    }
+    out.cumulative = (cumulative_idx >= 0) ? static_cast<uint32_t>(cumulative_idx) : UINT32_MAX;
+    for (uint32_t c = 0; c < total_chunks && c < 512; ++c) {
+        if (fb.is_chunk_complete(c)) {
+            out.words[c / 64] |= (1ULL << (c % 64));
+        }
+    }
+    for (uint32_t c = 0; c < total_chunks; ++c) {
+        if (!fb.is_chunk_complete(c)) {
+            out.missing_start = c;
+            uint32_t run = 0;
+            while (c < total_chunks && !fb.is_chunk_complete(c)) {
+                ++run; ++c;
+            }
+            out.missing_len = run;
+            break;
+        }
+    }
+    for (uint32_t c = 0; c < total_chunks && out.num_gaps < 4; ++c) {
+        if (!fb.is_chunk_complete(c)) {
+            uint32_t start = c;
+            uint32_t len = 0;
+            while (c < total_chunks && !fb.is_chunk_complete(c)) {
+                ++len; ++c;
+            }
+            out.gap_start[out.num_gaps] = start;
+            out.gap_len[out.num_gaps] = len;
+            out.num_gaps++;
+        }
+    }
+    return out;
+}
+
+// SRReceiver::pump now: one snapshot, one extract_gaps pass
+Feedback kernel_feedback(const FrontendBitmap& fb, uint32_t total_chunks, std::vector<uint64_t>& words) {
+    Feedback out;
+    words.resize((total_chunks + 63) / 64);
+    uint32_t copied = fb.snapshot_chunk_bitmap(words.data(), static_cast<uint32_t>(words.size()));
+    std::fill(words.begin() + copied, words.end(), 0);
+    bitmap::Gap gaps[4];
+    size_t found = bitmap::extract_gaps(words.data(), total_chunks, gaps, 4);
+    uint32_t prefix = found ? gaps[0].start : total_chunks;
+    out.cumulative = prefix > 0 ? prefix - 1 : UINT32_MAX;
+    for (uint32_t i = 0; i < words.size() && i < 8; ++i) {
+        out.words[i] = words[i];
+    }
+    if (found) {
+        out.missing_start = gaps[0].start;
+        out.missing_len = gaps[0].len;
+    }
+    for (size_t i = 0; i < found; ++i) {
+        out.gap_start[i] = gaps[i].start;
+        out.gap_len[i] = gaps[i].len;
+    }
+    out.num_gaps = static_cast<uint32_t>(found);
+    return out;
+}
+
+// EC try_decode before the kernels: list every missing chunk, then collapse runs
+uint64_t legacy_gaps(const uint64_t* words, uint32_t nbits) {
+    std::vector<uint32_t> missing;
+    for (uint32_t c = 0; c < nbits; ++c) {
+        if ((words[c / 64] & (1ULL << (c % 64))) == 0) {
+            missing.push_back(c);
+        }
+    }
+    uint64_t checksum = 0;
+    size_t idx = 0;
+    while (idx < missing.size()) {
+        uint32_t start = missing[idx];
+        uint32_t run = 1;
+        idx++;
+        while (idx < missing.size() && missing[idx] == start + run) {
+            run++;
+            idx++;
+        }
+        checksum = checksum * 31 + start * 7 + run;
+    }
+    return checksum;
+}
+
+uint64_t kernel_gaps(const uint64_t* words, uint32_t nbits, std::vector<bitmap::Gap>& gaps) {
+    gaps.resize(nbits / 2 + 1);
+    size_t found = bitmap::extract_gaps(words, nbits, gaps.data(), gaps.size());
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < found; ++i) {
+        checksum = checksum * 31 + gaps[i].start * 7 + gaps[i].len;
+    }
+    return checksum;
+}
+
+uint64_t legacy_popcount(const uint64_t* words, uint32_t nbits) {
+    uint64_t count = 0;
+    for (uint32_t c = 0; c < nbits; ++c) {
+        if (words[c / 64] & (1ULL << (c % 64))) count++;
+    }
+    return count;
+}
+
+// SR/EC sender apply_bitmap before the kernels
+uint64_t legacy_apply(const uint64_t* words, uint32_t nbits, std::vector<bool>& acked) {
+    uint64_t marked = 0;
+    for (uint32_t w = 0; w < 8; ++w) {
+        uint64_t word = words[w];
+        for (uint32_t bit = 0; bit < 64; ++bit) {
+            uint32_t chunk_id = w * 64 + bit;
+            if (chunk_id >= nbits) break;
+            if (word & (1ULL << bit)) {
+                if (!acked[chunk_id]) marked++;
+                acked[chunk_id] = true;
+            }
+        }
+    }
+    return marked;
+}
+
+uint64_t kernel_apply(const uint64_t* words, uint32_t nbits, std::vector<bool>& acked) {
+    uint64_t marked = 0;
+    bitmap::for_each_set_bit(words, std::min<uint32_t>(nbits, 512), [&](uint32_t chunk_id) {
+        if (!acked[chunk_id]) marked++;
+        acked[chunk_id] = true;
+    });
+    return marked;
+}
+
+// Average nanoseconds per call of fn over iterations; sink keeps results live
+template <typename Fn>
+double time_ns(uint32_t iterations, uint64_t& sink, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        sink += fn();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t iterations = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 2000;
+    const bool have_avx2 = bitmap::set_isa(bitmap::Isa::AVX2);
+    const bitmap::Isa isas[2] = {bitmap::Isa::SCALAR, bitmap::Isa::AVX2};
+
+    std::cout << "[Bench] " << iterations << " iterations per cell, AVX2 "
+              << (have_avx2 ? "available" : "not available (scalar only)") << std::endl;
+    std::cout << std::setw(8) << "chunks" << std::setw(6) << "loss" << std::setw(10) << "op"
+              << std::setw(14) << "legacy ns" << std::setw(14) << "scalar ns" << std::setw(14) << "avx2 ns"
+              << std::setw(10) << "speedup" << std::endl;
+
+    std::mt19937 rng(42);
+    uint64_t sink = 0;
+    for (uint32_t total_chunks : {512u, 4096u, 65535u}) {
+        for (uint32_t loss_pct : {1u, 10u, 50u}) {
+            // Chunk bitmap with loss_pct% of chunks missing
+            auto backend = std::make_shared<BackendBitmap>(total_chunks, 1);
+            FrontendBitmap frontend(backend, total_chunks);
+            std::uniform_int_distribution<uint32_t> pct(0, 99);
+            for (uint32_t c = 0; c < total_chunks; ++c) {
+                if (pct(rng) >= loss_pct) {
+                    frontend.mark_chunk_complete(c);
+                }
+            }
+            std::vector<uint64_t> words((total_chunks + 63) / 64, 0);
+            frontend.snapshot_chunk_bitmap(words.data(), static_cast<uint32_t>(words.size()));
+            std::vector<uint64_t> scratch;
+            std::vector<bitmap::Gap> gaps;
+            std::vector<bool> acked(total_chunks, false);
+
+            const char* ops[4] = {"feedback", "gaps", "popcount", "apply"};
+            for (int op = 0; op < 4; ++op) {
+                double ns[3] = {0.0, 0.0, 0.0};
+                bool match = true;
+                // Legacy result, then each kernel ISA must reproduce it
+                uint64_t expect = 0;
+                Feedback expect_fb;
+                switch (op) {
+                    case 0:
+                        expect_fb = legacy_feedback(frontend, total_chunks);
+                        ns[0] = time_ns(iterations, sink, [&] { return legacy_feedback(frontend, total_chunks).cumulative; });
+                        break;
+                    case 1:
+                        expect = legacy_gaps(words.data(), total_chunks);
+                        ns[0] = time_ns(iterations, sink, [&] { return legacy_gaps(words.data(), total_chunks); });
+                        break;
+                    case 2:
+                        expect = legacy_popcount(words.data(), total_chunks);
+                        ns[0] = time_ns(iterations, sink, [&] { return legacy_popcount(words.data(), total_chunks); });
+                        break;
+                    default:
+                        expect = legacy_apply(words.data(), total_chunks, acked);
+                        ns[0] = time_ns(iterations, sink, [&] { return legacy_apply(words.data(), total_chunks, acked); });
+                        break;
+                }
+                for (int v = 0; v < 2; ++v) {
+                    if (!bitmap::set_isa(isas[v])) {
+                        continue;
+                    }
+                    switch (op) {
+                        case 0:
+                            match = match && kernel_feedback(frontend, total_chunks, scratch) == expect_fb;
+                            ns[v + 1] = time_ns(iterations, sink, [&] { return kernel_feedback(frontend, total_chunks, scratch).cumulative; });
+                            break;
+                        case 1:
+                            match = match && kernel_gaps(words.data(), total_chunks, gaps) == expect;
+                            ns[v + 1] = time_ns(iterations, sink, [&] { return kernel_gaps(words.data(), total_chunks, gaps); });
+                            break;
+                        case 2:
+                            match = match && bitmap::popcount(words.data(), total_chunks) == expect;
+                            ns[v + 1] = time_ns(iterations, sink, [&] { return bitmap::popcount(words.data(), total_chunks); });
+                            break;
+                        default:
+                            acked.assign(total_chunks, false);
+                            match = match && kernel_apply(words.data(), total_chunks, acked) == expect;
+                            ns[v + 1] = time_ns(iterations, sink, [&] { return kernel_apply(words.data(), total_chunks, acked); });
+                            break;
+                    }
+                }
+                double best = have_avx2 ? ns[2] : ns[1];
+                std::cout << std::setw(8) << total_chunks << std::setw(5) << loss_pct << "%" << std::setw(10) << ops[op]
+                          << std::setw(14) << std::fixed << std::setprecision(1) << ns[0]
+                          << std::setw(14) << ns[1];
+                if (have_avx2) {
+                    std::cout << std::setw(14) << ns[2];
+                } else {
+                    std::cout << std::setw(14) << "-";
+                }
+                std::cout << std::setw(9) << (best > 0 ? ns[0] / best : 0.0) << "x";
+                if (!match) {
+                    std::cout << "  (MISMATCH)";
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+    bitmap::set_isa(have_avx2 ? bitmap::Isa::AVX2 : bitmap::Isa::SCALAR);
+    return sink == 0x5eed ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+// Frontend scan benchmark: cost of one FrontendBitmap polling pass while a message
+// fills in, full rescan of every chunk vs. the backend's dirty-word summary.
+// Packets arrive in order in equal batches with one pass after each batch.
+// Usage: sdr_bench_bitmap_scan [mtu_bytes] [packets_per_chunk] [passes]
+#include "sdr_backend.h"
+#include "sdr_frontend.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <memory>
+
+using namespace sdr;
+
+namespace {
+
+// The scan before the summary existed: every incomplete chunk on every pass,
+// with chunk masks built one bit at a time
+bool full_scan_chunk_complete(const BackendBitmap& backend, uint32_t chunk_id) {
+    const std::atomic<uint64_t>* words = backend.get_packet_bitmap();
+    uint32_t start = chunk_id * backend.get_packets_per_chunk();
+    uint32_t end = std::min<uint32_t>(start + backend.get_packets_per_chunk(), backend.get_total_packets());
+    for (uint32_t word = start / 64; word <= (end - 1) / 64; ++word) {
+        uint32_t lo = word == start / 64 ? start % 64 : 0;
+        uint32_t hi = word == (end - 1) / 64 ? (end - 1) % 64 + 1 : 64;
+        uint64_t mask = 0;
+        for (uint32_t bit = lo; bit < hi; ++bit) {
+            mask |= (1ULL << bit);
+        }
+        if ((words[word].load(std::memory_order_acquire) & mask) != mask) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t full_scan(const BackendBitmap& backend, std::vector<uint8_t>& complete) {
+    uint32_t newly = 0;
+    for (uint32_t c = 0; c < complete.size(); ++c) {
+        if (!complete[c] && full_scan_chunk_complete(backend, c)) {
+            complete[c] = 1;
+            newly++;
+        }
+    }
+    return newly;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t mtu_bytes = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 1024;
+    uint16_t packets_per_chunk = argc > 2 ? static_cast<uint16_t>(std::stoul(argv[2])) : 64;
+    uint32_t passes = argc > 3 ? static_cast<uint32_t>(std::stoul(argv[3])) : 1024;
+
+    std::cout << "[Bench] mtu " << mtu_bytes << " B, " << packets_per_chunk << " packets/chunk, "
+              << passes << " scan passes per message" << std::endl;
+    std::cout << std::setw(10) << "message" << std::setw(12) << "packets" << std::setw(16) << "full us/pass"
+              << std::setw(16) << "dirty us/pass" << std::setw(10) << "speedup" << std::endl;
+
+    for (uint64_t mib = 1; mib <= 1024; mib *= 4) {
+        uint32_t total_packets = static_cast<uint32_t>((mib << 20) / mtu_bytes);
+        uint32_t total_chunks = (total_packets + packets_per_chunk - 1) / packets_per_chunk;
+        uint32_t batch = std::max<uint32_t>(1, total_packets / passes);
+
+        double seconds[2] = {0.0, 0.0};
+        uint32_t found[2] = {0, 0};
+        for (int variant = 0; variant < 2; ++variant) {
+            auto backend = std::make_shared<BackendBitmap>(total_packets, packets_per_chunk);
+            FrontendBitmap frontend(backend, total_chunks);
+            std::vector<uint8_t> complete(total_chunks, 0);
+            if (variant == 1) {
+                backend->enable_dirty_tracking();
+            }
+
+            for (uint32_t next = 0; next < total_packets;) {
+                uint32_t end = std::min(total_packets, next + batch);
+                for (; next < end; ++next) {
+                    backend->set_packet_received(next);
+                }
+                auto start = std::chrono::steady_clock::now();
+                if (variant == 0) {
+                    found[0] += full_scan(*backend, complete);
+                } else {
+                    frontend.poll_once();
+                }
+                seconds[variant] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            }
+            if (variant == 1) {
+                // Maintained counters must agree with a popcount recount
+                found[1] = frontend.get_total_chunks_completed();
+                if (found[1] != frontend.count_chunks_completed_exact() ||
+                    backend->get_total_packets_received() != backend->count_packets_received_exact()) {
+                    found[1] = 0;
+                }
+            }
+        }
+
+        uint32_t pass_count = (total_packets + batch - 1) / batch;
+        double full_us = seconds[0] * 1e6 / pass_count;
+        double dirty_us = seconds[1] * 1e6 / pass_count;
+        std::cout << std::setw(6) << mib << " MiB" << std::setw(12) << total_packets
+                  << std::setw(16) << std::fixed << std::setprecision(2) << full_us
+                  << std::setw(16) << dirty_us
+                  << std::setw(9) << std::setprecision(1) << (dirty_us > 0 ? full_us / dirty_us : 0.0) << "x";
+        if (found[0] != total_chunks || found[1] != total_chunks) {
+            std::cout << "  (MISMATCH: " << found[0] << "/" << found[1] << " of " << total_chunks << " chunks)";
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
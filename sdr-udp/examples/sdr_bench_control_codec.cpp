@@ -0,0 +1,176 @@
+// Control message encoding benchmark: wire bytes of the TLV/varint format against
+// the previous whole-struct memcpy, per message type and for a whole SR transfer,
+// plus encode/decode cost. Every message is decoded and re-encoded to check the
+// round trip. SR feedback covers 512 chunks with random loss; the SR_BITMAP
+// sample is one of those windows far into a large message.
+// Usage: sdr_bench_control_codec [iterations] [acks_per_transfer]
+#include "tcp_control.h"
+#include "sdr_bitmap_kernels.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstring>
+
+using namespace sdr;
+
+namespace {
+
+// The memcpy format sent the whole struct as it was before the feedback fields were added
+constexpr size_t LEGACY_WIRE_BYTES = 344;
+constexpr uint32_t SR_CHUNKS = 512;
+
+struct Sample {
+    std::string name;
+    ControlMessage msg;
+};
+
+ControlMessage handshake(ControlMsgType type) {
+    ControlMessage msg{};
+    msg.magic = ControlMessage::MAGIC_VALUE;
+    msg.msg_type = type;
+    msg.connection_id = 4242;
+    msg.params.transfer_id = 17;
+    msg.params.total_bytes = 64ull * 1024 * 1024;
+    msg.params.mtu_bytes = 8192;
+    msg.params.packets_per_chunk = 64;
+    msg.params.num_channels = 4;
+    msg.params.channel_base_port = 9999;
+    msg.params.udp_server_port = 9999;
+    msg.params.udp_offload = UDP_OFFLOAD_GSO;
+    msg.params.pacing_rate = 1250000000;
+    msg.params.msg_id = 12;
+    std::strncpy(msg.params.udp_server_ip, "10.0.0.12", sizeof(msg.params.udp_server_ip) - 1);
+    return msg;
+}
+
+// SR feedback as SRReceiver builds it, for a bitmap with the given loss rate
+ControlMessage sr_feedback(double loss, std::mt19937& rng) {
+    ControlMessage msg{};
+    msg.magic = ControlMessage::MAGIC_VALUE;
+    msg.connection_id = 4242;
+    std::vector<uint64_t> words(SR_CHUNKS / 64, 0);
+    std::bernoulli_distribution lost(loss);
+    for (uint32_t c = 0; c < SR_CHUNKS; ++c) {
+        if (!lost(rng)) words[c / 64] |= 1ULL << (c % 64);
+    }
+    bitmap::Gap gaps[4];
+    size_t gaps_found = bitmap::extract_gaps(words.data(), SR_CHUNKS, gaps, 4);
+    msg.msg_type = gaps_found ? ControlMsgType::SR_NACK : ControlMsgType::SR_ACK;
+    msg.total_chunks = SR_CHUNKS;
+    msg.acked_prefix = gaps_found ? gaps[0].start : SR_CHUNKS;
+    msg.ack_delay_us = 850;
+    msg.chunk_bitmap_words = static_cast<uint16_t>(words.size());
+    std::copy(words.begin(), words.end(), msg.chunk_bitmap);
+    for (size_t i = 0; i < gaps_found; ++i) {
+        msg.gap_start[i] = gaps[i].start;
+        msg.gap_len[i] = gaps[i].len;
+    }
+    msg.num_gaps = static_cast<uint16_t>(gaps_found);
+    if (gaps_found) {
+        msg.nack_start = gaps[0].start;
+        msg.nack_len = gaps[0].len;
+    }
+    return msg;
+}
+
+// SR_BITMAP fragment as SRReceiver sends past its ACK window: the same bitmap at base
+ControlMessage sr_fragment(double loss, uint32_t base, std::mt19937& rng) {
+    ControlMessage msg = sr_feedback(loss, rng);
+    msg.msg_type = ControlMsgType::SR_BITMAP;
+    msg.acked_prefix = base / 2;
+    msg.total_chunks = base * 2;
+    msg.bitmap_base = base;
+    msg.ack_delay_us = 0;
+    msg.nack_start = 0;
+    msg.nack_len = 0;
+    msg.num_gaps = 0;
+    return msg;
+}
+
+bool round_trip(const ControlMessage& msg, size_t& wire_bytes) {
+    uint8_t wire[ControlMessage::MAX_WIRE_SIZE];
+    uint8_t again[ControlMessage::MAX_WIRE_SIZE];
+    wire_bytes = msg.serialize(wire, sizeof(wire));
+    ControlMessage decoded;
+    if (wire_bytes == 0 || ControlMessage::frame_length(wire) != wire_bytes ||
+        !decoded.deserialize(wire, wire_bytes)) {
+        return false;
+    }
+    size_t again_bytes = decoded.serialize(again, sizeof(again));
+    return again_bytes == wire_bytes && std::memcmp(wire, again, wire_bytes) == 0 &&
+           decoded.msg_type == msg.msg_type && decoded.connection_id == msg.connection_id &&
+           decoded.bitmap_base == msg.bitmap_base &&
+           std::memcmp(decoded.chunk_bitmap, msg.chunk_bitmap, msg.chunk_bitmap_words * sizeof(uint64_t)) == 0 &&
+           std::memcmp(decoded.gap_start, msg.gap_start, msg.num_gaps * sizeof(uint32_t)) == 0 &&
+           std::strcmp(decoded.params.udp_server_ip, msg.params.udp_server_ip) == 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t iterations = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 200000;
+    uint32_t acks_per_transfer = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 20;
+
+    std::mt19937 rng(7);
+    std::vector<Sample> samples;
+    samples.push_back({"OFFER", handshake(ControlMsgType::OFFER)});
+    samples.push_back({"CTS", handshake(ControlMsgType::CTS)});
+    samples.push_back({"ACCEPT", handshake(ControlMsgType::ACCEPT)});
+    ControlMessage complete{};
+    complete.magic = ControlMessage::MAGIC_VALUE;
+    complete.msg_type = ControlMsgType::COMPLETE_ACK;
+    complete.connection_id = 4242;
+    samples.push_back({"COMPLETE_ACK", complete});
+    samples.push_back({"SR feedback 0% loss", sr_feedback(0.0, rng)});
+    samples.push_back({"SR feedback 1% loss", sr_feedback(0.01, rng)});
+    samples.push_back({"SR feedback 10% loss", sr_feedback(0.10, rng)});
+    samples.push_back({"SR feedback 50% loss", sr_feedback(0.50, rng)});
+    samples.push_back({"SR_BITMAP 1% at 1M", sr_fragment(0.01, 1u << 20, rng)});
+
+    std::cout << "[Bench] " << iterations << " encode+decode per message, memcpy format "
+              << LEGACY_WIRE_BYTES << " bytes/message" << std::endl;
+    std::cout << std::left << std::setw(24) << "message" << std::right << std::setw(10) << "bytes"
+              << std::setw(10) << "ratio" << std::setw(12) << "enc ns" << std::setw(12) << "dec ns" << std::endl;
+
+    bool all_ok = true;
+    std::vector<size_t> sizes;
+    for (const Sample& s : samples) {
+        size_t bytes = 0;
+        bool ok = round_trip(s.msg, bytes);
+        all_ok = all_ok && ok;
+        sizes.push_back(bytes);
+
+        uint8_t wire[ControlMessage::MAX_WIRE_SIZE];
+        size_t checksum = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; ++i) {
+            checksum += s.msg.serialize(wire, sizeof(wire));
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        ControlMessage decoded;
+        for (uint32_t i = 0; i < iterations; ++i) {
+            checksum += decoded.deserialize(wire, bytes) ? decoded.chunk_bitmap_words : 0;
+        }
+        auto t2 = std::chrono::steady_clock::now();
+        double enc_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+        double dec_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / iterations;
+
+        std::cout << std::left << std::setw(24) << s.name << std::right << std::setw(10) << bytes
+                  << std::setw(9) << std::fixed << std::setprecision(1)
+                  << static_cast<double>(LEGACY_WIRE_BYTES) / bytes << "x"
+                  << std::setw(12) << enc_ns << std::setw(12) << dec_ns
+                  << (ok ? "" : "  ROUND TRIP FAILED") << (checksum == 0 ? " (no output)" : "") << std::endl;
+    }
+
+    // OFFER + CTS + ACCEPT, the ACKs (1% loss feedback) and COMPLETE_ACK
+    uint32_t messages = 3 + acks_per_transfer + 1;
+    size_t legacy_total = static_cast<size_t>(messages) * LEGACY_WIRE_BYTES;
+    size_t wire_total = sizes[0] + sizes[1] + sizes[2] + acks_per_transfer * sizes[5] + sizes[3];
+    std::cout << "[Bench] SR transfer with " << acks_per_transfer << " ACKs: " << legacy_total << " -> "
+              << wire_total << " control bytes (" << std::setprecision(1)
+              << static_cast<double>(legacy_total) / wire_total << "x)" << std::endl;
+    return all_ok ? 0 : 1;
+}
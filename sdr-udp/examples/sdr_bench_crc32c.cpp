@@ -0,0 +1,175 @@
+// CRC32C benchmark: GB/s per core of the scalar (slicing-by-8) and SSE4.2
+// (three-lane crc32 + PCLMULQDQ fold) kernels by buffer size on cache-resident
+// data, then the cost of packet CRCs on the data path over a 64 MiB message:
+// PacketBuilder::build with and without stamping (ns/packet, and GB/s of payload
+// with it) and decode + verify on the receive side. Kernels are first
+// checked against each other and the standard check value; exits non-zero on a
+// mismatch. Time an optimized build (CMAKE_BUILD_TYPE=Release).
+// Usage: sdr_bench_crc32c [mtu_bytes] [megabytes_per_run]
+#include "sdr_crc32c.h"
+#include "sdr_header_codec.h"
+#include "sdr_sender.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+
+using namespace sdr;
+
+namespace {
+
+constexpr uint32_t CHECK_VALUE = 0xE3069283;   // CRC32C of "123456789"
+constexpr size_t MESSAGE_BYTES = 64 * 1024 * 1024;
+constexpr size_t HOT_BYTES = 1024 * 1024;      // Kernel runs cycle through this much data
+
+bool kernels_agree(const std::vector<uint8_t>& data, bool have_sse42) {
+    if (crc32c::compute("123456789", 9) != CHECK_VALUE) {
+        return false;
+    }
+    if (!have_sse42) {
+        return true;
+    }
+    std::mt19937 rng(24);
+    for (uint32_t i = 0; i < 20000; ++i) {
+        size_t offset = rng() % 64;
+        size_t len = rng() % (i % 1000 == 0 ? data.size() - 64 : 10000);
+        size_t split = len ? rng() % len : 0;
+        crc32c::set_isa(crc32c::Isa::SCALAR);
+        uint32_t expected = crc32c::compute(data.data() + offset, len);
+        crc32c::set_isa(crc32c::Isa::SSE42);
+        uint32_t whole = crc32c::compute(data.data() + offset, len);
+        uint32_t pieces = crc32c::extend(crc32c::compute(data.data() + offset, split),
+                                         data.data() + offset + split, len - split);
+        if (whole != expected || pieces != expected) {
+            std::cerr << "[Bench] SSE4.2 CRC differs from scalar at length " << len << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+double gbps(size_t bytes, Fn&& fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return static_cast<double>(bytes) / std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+// Build every packet of the message, as the send loop does; returns payload bytes,
+// 0 if a packet fails to build
+size_t build_all(PacketBuilder& builder, uint64_t& sink) {
+    struct iovec iov[2];
+    size_t bytes = 0;
+    for (uint32_t p = 0; p < builder.total_packets(); ++p) {
+        size_t wire_bytes = builder.build(p, iov);
+        if (wire_bytes == 0) {
+            return 0;
+        }
+        bytes += wire_bytes - iov[0].iov_len;
+        sink += static_cast<const uint8_t*>(iov[0].iov_base)[sizeof(SDRPacketHeader) - 1];
+    }
+    return bytes;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t mtu_bytes = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 8192;
+    size_t run_bytes = (argc > 2 ? std::stoull(argv[2]) : 1024) * 1024 * 1024;
+
+    std::vector<uint8_t> message(MESSAGE_BYTES);
+    std::mt19937_64 rng(7);
+    for (size_t i = 0; i < message.size(); i += 8) {
+        uint64_t v = rng();
+        std::memcpy(&message[i], &v, sizeof(v));
+    }
+
+    const bool have_sse42 = crc32c::set_isa(crc32c::Isa::SSE42);
+    bool ok = kernels_agree(message, have_sse42);
+    crc32c::set_isa(crc32c::Isa::SCALAR);
+    ok = ok && kernels_agree(message, false);
+    std::cout << "[Bench] CRC32C check value and scalar/SSE4.2 agreement: " << (ok ? "ok" : "MISMATCH")
+              << (have_sse42 ? "" : " (no SSE4.2/PCLMULQDQ, scalar only)") << std::endl;
+
+    std::cout << "[Bench] Kernel throughput, GB/s per core (cache-resident)" << std::endl;
+    std::cout << std::setw(10) << "bytes" << std::setw(12) << "scalar" << std::setw(12) << "sse4.2" << std::endl;
+    const crc32c::Isa isas[2] = {crc32c::Isa::SCALAR, crc32c::Isa::SSE42};
+    uint64_t sink = 0;
+    for (size_t size : {64u, 256u, 1024u, 1500u, 4096u, 8192u, 65536u, 1u << 20}) {
+        std::cout << std::setw(10) << size;
+        for (crc32c::Isa isa : isas) {
+            if (!crc32c::set_isa(isa)) {
+                std::cout << std::setw(12) << "-";
+                continue;
+            }
+            size_t buffers = std::max<size_t>(1, run_bytes / size);
+            double rate = gbps(buffers * size, [&] {
+                for (size_t b = 0; b < buffers; ++b) {
+                    sink += crc32c::compute(message.data() + (b * size) % HOT_BYTES, size);
+                }
+            });
+            std::cout << std::setw(12) << std::fixed << std::setprecision(2) << rate;
+        }
+        std::cout << std::endl;
+    }
+    crc32c::set_isa(have_sse42 ? crc32c::Isa::SSE42 : crc32c::Isa::SCALAR);
+
+    // Data path at this MTU over a 64 MiB message: send-side build, receive-side decode + verify
+    PacketBuilder builder;
+    uint32_t passes = static_cast<uint32_t>(std::max<size_t>(1, run_bytes / MESSAGE_BYTES));
+    double build_ns[2] = {0, 0};
+    double build_crc_gbps = 0;
+    for (bool checksum : {false, true}) {
+        builder.set_message(1, 0, 64, mtu_bytes, message.data(), message.size(), 7, HeaderFormat::STANDARD,
+                            checksum);
+        bool built = true;
+        double rate = gbps(passes * message.size(), [&] {
+            for (uint32_t i = 0; i < passes; ++i) built = build_all(builder, sink) > 0 && built;
+        });
+        if (!built) {
+            std::cerr << "[Bench] PacketBuilder::build failed" << std::endl;
+            return 1;
+        }
+        build_ns[checksum] = static_cast<double>(message.size()) / rate / builder.total_packets();
+        build_crc_gbps = rate;
+    }
+
+    // Stamped headers of every packet, then decode and verify against the payloads
+    uint32_t packets = builder.total_packets();
+    std::vector<uint8_t> headers(static_cast<size_t>(packets) * sizeof(SDRPacketHeader));
+    std::vector<const uint8_t*> payloads(packets);
+    std::vector<size_t> payload_lens(packets);
+    for (uint32_t p = 0; p < packets; ++p) {
+        struct iovec iov[2];
+        if (builder.build(p, iov) == 0) {
+            std::cerr << "[Bench] PacketBuilder::build failed for packet " << p << std::endl;
+            return 1;
+        }
+        std::memcpy(&headers[p * sizeof(SDRPacketHeader)], iov[0].iov_base, sizeof(SDRPacketHeader));
+        payloads[p] = static_cast<const uint8_t*>(iov[1].iov_base);
+        payload_lens[p] = iov[1].iov_len;
+    }
+    uint64_t verified = 0;
+    double verify = gbps(passes * message.size(), [&] {
+        for (uint32_t i = 0; i < passes; ++i) {
+            for (uint32_t p = 0; p < packets; ++p) {
+                PacketInfo info;
+                verified += header_codec::decode(&headers[p * sizeof(SDRPacketHeader)], sizeof(SDRPacketHeader), info) &&
+                            header_codec::verify_crc(info, payloads[p], payload_lens[p]);
+            }
+        }
+    });
+    ok = ok && verified == static_cast<uint64_t>(passes) * packets;
+
+    std::cout << "[Bench] " << mtu_bytes << "-byte packets (" << crc32c::isa_name(crc32c::active_isa())
+              << "), GB/s of payload per core" << std::endl;
+    std::cout << "  build " << std::setprecision(1) << build_ns[0] << " ns/packet without CRC, " << build_ns[1]
+              << " with (" << std::setprecision(2) << build_crc_gbps << " GB/s); receive decode + verify "
+              << verify << " GB/s"
+              << (verified == static_cast<uint64_t>(passes) * packets ? "" : "  VERIFY FAILED")
+              << (sink == 0 ? " (no output)" : "") << std::endl;
+    return ok ? 0 : 1;
+}
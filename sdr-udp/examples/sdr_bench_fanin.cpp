@@ -0,0 +1,177 @@
+// Loopback fan-in benchmark: N senders, each with its own control connection,
+// transfer into one listening receiver. Every sender is accepted as a separate
+// session (sdr_accept) and all sessions share the listening socket and the
+// process-wide RXEngine. Reports aggregate goodput per sender count.
+// Usage: sdr_bench_fanin [max_senders] [message_bytes] [messages_per_sender] [pacing_mbps]
+#include "sdr_api.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstring>
+
+using namespace sdr;
+
+namespace {
+
+constexpr uint16_t TCP_PORT = 47000;
+constexpr uint16_t UDP_PORT = 47100;
+constexpr uint32_t MTU_BYTES = 8192;       // Jumbo-frame sized payloads
+constexpr uint16_t PACKETS_PER_CHUNK = 64;
+constexpr int RECEIVE_TIMEOUT_MS = 5000;
+
+struct RunResult {
+    double seconds;
+    uint32_t completed;
+    uint32_t failed;
+};
+
+// Receive messages on one session until the sender has sent them all
+void serve_session(SDRConnection* session, size_t message_bytes, uint32_t messages,
+                   std::atomic<uint32_t>& completed) {
+    std::vector<uint8_t> buffer(message_bytes);
+    uint32_t chunk_ids[256];
+    for (uint32_t m = 0; m < messages; ++m) {
+        SDRRecvHandle* handle = nullptr;
+        if (sdr_recv_post(session, buffer.data(), buffer.size(), &handle) != 0) {
+            break;
+        }
+        FrontendBitmap& frontend = *handle->msg_ctx->frontend_bitmap;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(RECEIVE_TIMEOUT_MS);
+        while (frontend.get_total_chunks_completed() < handle->msg_ctx->total_chunks &&
+               std::chrono::steady_clock::now() < deadline) {
+            if (frontend.wait_for_completion(20)) {
+                frontend.drain_completions(chunk_ids, 256);
+            }
+        }
+        if (frontend.get_total_chunks_completed() >= handle->msg_ctx->total_chunks) {
+            completed.fetch_add(1);
+        }
+        sdr_recv_complete(handle); // COMPLETE_ACK or INCOMPLETE_NACK, so the sender moves on
+        delete handle;
+    }
+    sdr_disconnect(session);
+}
+
+RunResult run(SDRConnection* listener, uint32_t senders, size_t message_bytes, uint32_t messages,
+              uint64_t pacing_rate) {
+    std::atomic<uint32_t> completed{0};
+    std::atomic<uint32_t> failed{0};
+    std::vector<std::thread> sessions;
+
+    std::thread acceptor([&] {
+        for (uint32_t s = 0; s < senders; ++s) {
+            SDRConnection* session = sdr_accept(listener);
+            if (!session) {
+                failed.fetch_add(messages);
+                continue;
+            }
+            sessions.emplace_back(serve_session, session, message_bytes, messages, std::ref(completed));
+        }
+    });
+
+    std::vector<uint8_t> payload(message_bytes);
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<uint8_t>(i * 131);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t s = 0; s < senders; ++s) {
+        threads.emplace_back([&] {
+            SDRContext* ctx = sdr_ctx_create("bench_sender");
+            SDRConnection* conn = sdr_connect(ctx, "127.0.0.1", TCP_PORT);
+            if (!conn) {
+                failed.fetch_add(messages);
+                sdr_ctx_destroy(ctx);
+                return;
+            }
+            ConnectionParams params;
+            std::memset(&params, 0, sizeof(params));
+            params.mtu_bytes = MTU_BYTES;
+            params.packets_per_chunk = PACKETS_PER_CHUNK;
+            params.num_channels = 1;
+            params.pacing_rate = pacing_rate;
+            sdr_set_params(conn, &params);
+            for (uint32_t m = 0; m < messages; ++m) {
+                SDRSendHandle* handle = nullptr;
+                if (sdr_send_post(conn, payload.data(), payload.size(), &handle) != 0) {
+                    failed.fetch_add(messages - m);
+                    break;
+                }
+                if (sdr_send_poll(handle) != 0) {
+                    failed.fetch_add(1);
+                }
+                delete handle;
+            }
+            sdr_disconnect(conn);
+            sdr_ctx_destroy(ctx);
+        });
+    }
+    for (auto& t : threads) t.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    acceptor.join();
+    for (auto& t : sessions) t.join();
+    return RunResult{seconds, completed.load(), failed.load()};
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t max_senders = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 8;
+    size_t message_bytes = argc > 2 ? std::stoull(argv[2]) : 4 * 1024 * 1024;
+    uint32_t messages = argc > 3 ? static_cast<uint32_t>(std::stoul(argv[3])) : 4;
+    uint64_t pacing_rate = argc > 4 ? std::stoull(argv[4]) * 1000000 / 8 : 0;
+    max_senders = std::max<uint32_t>(1, max_senders);
+
+    SDRContext* ctx = sdr_ctx_create("bench_receiver");
+    SDRConnection* listener = sdr_listen(ctx, TCP_PORT);
+    if (!listener) {
+        std::cerr << "[Bench] Failed to listen on port " << TCP_PORT << std::endl;
+        sdr_ctx_destroy(ctx);
+        return 1;
+    }
+    ConnectionParams params;
+    std::memset(&params, 0, sizeof(params));
+    params.mtu_bytes = MTU_BYTES;
+    params.packets_per_chunk = PACKETS_PER_CHUNK;
+    params.udp_server_port = UDP_PORT;
+    params.channel_base_port = UDP_PORT;
+    params.num_channels = 1;
+    std::strncpy(params.udp_server_ip, "127.0.0.1", sizeof(params.udp_server_ip) - 1);
+    sdr_set_params(listener, &params);
+
+    std::vector<uint32_t> counts;
+    for (uint32_t n = 1; n < max_senders; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(max_senders);
+
+    // The library logs every handshake; keep the table readable
+    std::ostream out(std::cout.rdbuf());
+    out << "[Bench] " << messages << " x " << message_bytes << " bytes per sender, "
+        << std::thread::hardware_concurrency() << " CPUs"
+        << (pacing_rate ? ", paced at " + std::to_string(pacing_rate * 8 / 1000000) + " Mbit/s" : std::string())
+        << std::endl;
+    out << std::setw(8) << "senders" << std::setw(14) << "total MB/s" << std::setw(16) << "per-sender MB/s"
+        << std::setw(12) << "complete" << std::setw(10) << "failed" << std::endl;
+    std::cout.rdbuf(nullptr);
+
+    for (uint32_t senders : counts) {
+        RunResult r = run(listener, senders, message_bytes, messages, pacing_rate);
+        double total_mb = static_cast<double>(r.completed) * message_bytes / 1e6;
+        out << std::setw(8) << senders
+            << std::setw(14) << std::fixed << std::setprecision(1) << total_mb / r.seconds
+            << std::setw(16) << total_mb / r.seconds / senders
+            << std::setw(8) << r.completed << "/" << std::left << std::setw(3) << senders * messages
+            << std::right << std::setw(10) << r.failed << std::endl;
+    }
+
+    std::cout.rdbuf(out.rdbuf());
+    sdr_disconnect(listener);
+    sdr_ctx_destroy(ctx);
+    return 0;
+}
@@ -0,0 +1,284 @@
+// Data header codec benchmark: the explicit wire codec (header_codec) against the
+// packed-struct path it replaced (memcpy the struct, swap each field, read the
+// bitfields). Fuzzes both directions first: random fields must encode to the same
+// bytes as the structs, and random datagrams (valid magic or not) must decode to
+// the same fields or be rejected by both. Then reports ns/packet for each layout:
+// whole-header encode both ways, the per-packet send path (PacketBuilder encodes a
+// template once per message and patch()es each packet), and decode both ways.
+// Exits non-zero on any mismatch. Time an optimized build (CMAKE_BUILD_TYPE=Release);
+// unoptimized, the codec's small helpers are real calls and dominate.
+// Usage: sdr_bench_header_codec [fuzz_cases] [iterations]
+#include "sdr_header_codec.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstring>
+
+using namespace sdr;
+
+namespace {
+
+constexpr size_t RING = 1024;    // Headers cycled through by the timing loops
+constexpr HeaderFormat FORMATS[] = {HeaderFormat::STANDARD, HeaderFormat::WIDE, HeaderFormat::COMPACT};
+
+const char* format_name(HeaderFormat format) {
+    switch (format) {
+    case HeaderFormat::WIDE: return "wide";
+    case HeaderFormat::COMPACT: return "compact";
+    case HeaderFormat::STANDARD: break;
+    }
+    return "standard";
+}
+
+// Header as PacketBuilder built it from the structs
+void struct_encode(HeaderFormat format, const header_codec::HeaderFields& f, uint8_t* out) {
+    if (format == HeaderFormat::COMPACT) {
+        SDRCompactHeader h{};
+        h.magic_version = SDRCompactHeader::MAGIC_VERSION;
+        h.flags = f.flags;
+        h.payload_len = htons(f.payload_len);
+        h.msg_key = htonl(SDRCompactHeader::make_key(f.transfer_id, f.msg_id));
+        h.packet_offset = htonl(f.packet_offset);
+        std::memcpy(out, &h, sizeof(h));
+        return;
+    }
+    if (format == HeaderFormat::WIDE) {
+        SDRWideHeader h{};
+        h.magic = SDRWideHeader::MAGIC_VALUE;
+        h.type = f.type;
+        h.flags = f.flags;
+        h.transfer_id = f.transfer_id;
+        h.packet_offset = f.packet_offset;
+        h.msg_id = f.msg_id;
+        h.chunk_seq = f.chunk_seq;
+        h.packets_per_chunk = f.packets_per_chunk;
+        h.payload_len = f.payload_len;
+        h.conn_id = f.conn_id & SDRPacketHeader::CONN_ID_MASK;
+        h.to_network_order();
+        std::memcpy(out, &h, sizeof(h));
+        return;
+    }
+    SDRPacketHeader h;
+    std::memset(&h, 0, sizeof(h));
+    h.magic = SDRPacketHeader::MAGIC_VALUE;
+    h.type = f.type;
+    h.transfer_id = f.transfer_id;
+    h.msg_id = f.msg_id & SDRPacketHeader::MAX_MSG_ID;
+    h.packet_offset = f.packet_offset & (SDRPacketHeader::MAX_PACKETS - 1);
+    h.chunk_seq = f.chunk_seq;
+    h.packets_per_chunk = f.packets_per_chunk;
+    h.payload_len = f.payload_len;
+    h.flags = f.flags;
+    h.conn_id = f.conn_id & SDRPacketHeader::CONN_ID_MASK;
+    h.to_network_order();
+    std::memcpy(out, &h, sizeof(h));
+}
+
+// The receiver's decode before header_codec
+bool struct_decode(const uint8_t* bytes, size_t len, PacketInfo& info) {
+    if (len >= sizeof(SDRCompactHeader) && bytes[0] == SDRCompactHeader::MAGIC_VERSION) {
+        SDRCompactHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+        uint32_t key = ntohl(header.msg_key);
+        info.transfer_id = key >> SDRCompactHeader::MSG_ID_BITS;
+        info.generation_mask = SDRCompactHeader::GENERATION_MASK;
+        info.msg_id = key & SDRPacketHeader::MAX_MSG_ID;
+        info.packet_offset = ntohl(header.packet_offset);
+        info.conn_id = 0;
+        info.payload_len = ntohs(header.payload_len);
+        info.type = static_cast<uint8_t>(PacketType::DATA);
+        info.flags = header.flags;
+        info.header_size = sizeof(SDRCompactHeader);
+        return true;
+    }
+    if (len < sizeof(SDRPacketHeader)) {
+        return false;
+    }
+    info.generation_mask = UINT32_MAX;
+    info.header_size = sizeof(SDRPacketHeader);
+    uint16_t magic;
+    std::memcpy(&magic, bytes, sizeof(magic));
+    magic = ntohs(magic);
+    if (magic == SDRPacketHeader::MAGIC_VALUE) {
+        SDRPacketHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+        header.to_host_order();
+        info.transfer_id = header.transfer_id;
+        info.msg_id = header.msg_id;
+        info.packet_offset = header.packet_offset;
+        info.conn_id = header.conn_id;
+        info.payload_len = header.payload_len;
+        info.type = header.type;
+        info.flags = header.flags;
+        return true;
+    }
+    if (magic == SDRWideHeader::MAGIC_VALUE) {
+        SDRWideHeader header;
+        std::memcpy(&header, bytes, sizeof(header));
+        uint64_t offset = be64toh(header.packet_offset);
+        if (offset > UINT32_MAX) {
+            return false;
+        }
+        info.transfer_id = ntohl(header.transfer_id);
+        info.msg_id = ntohl(header.msg_id);
+        info.packet_offset = static_cast<uint32_t>(offset);
+        info.conn_id = ntohl(header.conn_id) & SDRPacketHeader::CONN_ID_MASK;
+        info.payload_len = ntohs(header.payload_len);
+        info.type = header.type;
+        info.flags = header.flags;
+        return true;
+    }
+    return false;
+}
+
+bool same_info(const PacketInfo& a, const PacketInfo& b) {
+    return a.transfer_id == b.transfer_id && a.generation_mask == b.generation_mask && a.msg_id == b.msg_id &&
+           a.packet_offset == b.packet_offset && a.conn_id == b.conn_id && a.payload_len == b.payload_len &&
+           a.type == b.type && a.flags == b.flags && a.header_size == b.header_size;
+}
+
+header_codec::HeaderFields random_fields(HeaderFormat format, std::mt19937_64& rng) {
+    header_codec::HeaderFields f{};
+    f.type = static_cast<uint8_t>(rng());
+    // Checksummed headers also pay for a header CRC, which the struct path never had
+    f.flags = static_cast<uint8_t>(rng() & ~static_cast<uint64_t>(FLAG_CRC32C));
+    f.transfer_id = static_cast<uint32_t>(rng());
+    f.msg_id = static_cast<uint32_t>(rng()) & SDRPacketHeader::MAX_MSG_ID;
+    f.packet_offset = static_cast<uint32_t>(rng());
+    if (format == HeaderFormat::STANDARD) {
+        f.packet_offset &= SDRPacketHeader::MAX_PACKETS - 1;
+    }
+    f.packets_per_chunk = static_cast<uint16_t>(rng());
+    f.chunk_seq = f.packets_per_chunk ? f.packet_offset / f.packets_per_chunk : 0;
+    f.payload_len = static_cast<uint16_t>(rng());
+    f.conn_id = static_cast<uint32_t>(rng()) & SDRPacketHeader::CONN_ID_MASK;
+    return f;
+}
+
+// Encode (whole and as template + patch) and decode of random fields; false on mismatch
+bool fuzz_fields(HeaderFormat format, uint32_t cases, std::mt19937_64& rng) {
+    for (uint32_t i = 0; i < cases; ++i) {
+        header_codec::HeaderFields f = random_fields(format, rng);
+        uint8_t expected[32], encoded[32], patched[32];
+        struct_encode(format, f, expected);
+        header_codec::encode(format, f, encoded);
+
+        header_codec::HeaderFields per_message = f;
+        per_message.packet_offset = 0;
+        per_message.chunk_seq = 0;
+        per_message.payload_len = 0;
+        header_codec::encode(format, per_message, patched);
+        header_codec::patch(format, patched, f.msg_id, f.packet_offset, f.chunk_seq, f.payload_len);
+
+        size_t size = header_size(format);
+        PacketInfo reference{}, fast{};
+        bool ok = std::memcmp(expected, encoded, size) == 0 && std::memcmp(expected, patched, size) == 0 &&
+                  struct_decode(expected, size, reference) && header_codec::decode(expected, size, fast) &&
+                  same_info(reference, fast);
+        if (!ok) {
+            std::cerr << "[Bench] " << format_name(format) << " mismatch for msg_id " << f.msg_id
+                      << " offset " << f.packet_offset << " conn_id " << f.conn_id << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Random datagrams: both decoders must agree on accept/reject and on every field
+bool fuzz_bytes(uint32_t cases, std::mt19937_64& rng) {
+    const uint8_t leads[][2] = {{0x53, 0x44}, {0x53, 0x57}, {0xC1, 0x00}, {0x53, 0x00}};
+    uint8_t bytes[40];
+    for (uint32_t i = 0; i < cases; ++i) {
+        for (uint8_t& b : bytes) b = static_cast<uint8_t>(rng());
+        uint32_t lead = static_cast<uint32_t>(rng() % 5);
+        if (lead < 4) {
+            bytes[0] = leads[lead][0];
+            bytes[1] = lead == 2 ? bytes[1] : leads[lead][1];
+        }
+        if (lead == 1 && rng() % 2) {
+            std::memset(bytes + 8, 0, 4);   // Offsets that fit 32 bits
+        }
+        size_t len = rng() % (sizeof(bytes) + 1);
+        PacketInfo reference{}, fast{};
+        bool reference_ok = struct_decode(bytes, len, reference);
+        bool fast_ok = header_codec::decode(bytes, len, fast);
+        if (reference_ok != fast_ok || (reference_ok && !same_info(reference, fast))) {
+            std::cerr << "[Bench] Decoders disagree on a " << len << "-byte datagram starting 0x"
+                      << std::hex << static_cast<int>(bytes[0]) << std::dec << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+double ns_per_packet(uint32_t iterations, Fn&& fn) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        fn(i % RING);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / iterations;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t fuzz_cases = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 1000000;
+    uint32_t iterations = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 20000000;
+
+    std::mt19937_64 rng(23);
+    bool all_ok = fuzz_bytes(fuzz_cases, rng);
+    for (HeaderFormat format : FORMATS) {
+        all_ok = fuzz_fields(format, fuzz_cases, rng) && all_ok;
+    }
+    std::cout << "[Bench] Fuzz: " << fuzz_cases << " random datagrams and " << fuzz_cases
+              << " field sets per layout, " << (all_ok ? "codec matches the structs" : "MISMATCH") << std::endl;
+
+    std::cout << "[Bench] " << iterations << " headers per run, ns/packet" << std::endl;
+    std::cout << std::left << std::setw(10) << "layout" << std::right << std::setw(14) << "struct enc"
+              << std::setw(14) << "codec enc" << std::setw(14) << "codec patch" << std::setw(14) << "struct dec"
+              << std::setw(14) << "codec dec" << std::endl;
+    for (HeaderFormat format : FORMATS) {
+        std::vector<header_codec::HeaderFields> fields(RING);
+        std::vector<uint8_t> wire(RING * 32);
+        for (size_t i = 0; i < RING; ++i) {
+            fields[i] = random_fields(format, rng);
+            header_codec::encode(format, fields[i], &wire[i * 32]);
+        }
+        size_t size = header_size(format);
+        alignas(64) uint8_t out[32];
+        uint64_t checksum = 0;
+        PacketInfo info{};
+
+        double struct_enc = ns_per_packet(iterations, [&](size_t i) {
+            struct_encode(format, fields[i], out);
+            checksum += out[size - 1];
+        });
+        double codec_enc = ns_per_packet(iterations, [&](size_t i) {
+            header_codec::encode(format, fields[i], out);
+            checksum += out[size - 1];
+        });
+        header_codec::encode(format, fields[0], out);
+        double codec_patch = ns_per_packet(iterations, [&](size_t i) {
+            const header_codec::HeaderFields& f = fields[i];
+            header_codec::patch(format, out, f.msg_id, f.packet_offset, f.chunk_seq, f.payload_len);
+            checksum += out[size - 1];
+        });
+        double struct_dec = ns_per_packet(iterations, [&](size_t i) {
+            checksum += struct_decode(&wire[i * 32], size, info) ? info.packet_offset : 0;
+        });
+        double codec_dec = ns_per_packet(iterations, [&](size_t i) {
+            checksum += header_codec::decode(&wire[i * 32], size, info) ? info.packet_offset : 0;
+        });
+
+        std::cout << std::left << std::setw(10) << format_name(format) << std::right << std::fixed
+                  << std::setprecision(2) << std::setw(14) << struct_enc << std::setw(14) << codec_enc
+                  << std::setw(14) << codec_patch << std::setw(14) << struct_dec << std::setw(14) << codec_dec
+                  << (checksum == 0 ? "  (no output)" : "") << std::endl;
+    }
+    return all_ok ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+// Message table contention benchmark: receive-path lookups (get_message plus the
+// generation and state checks) from 1-16 threads while a writer recycles message
+// slots, with the previous mutex-protected table vs. the lock-free table with
+// epoch reclamation. Readers look up once per packet and pin once per batch, as
+// UDPReceiver does.
+// Usage: sdr_bench_msg_table [ms_per_run] [messages] [writer_period_us]
+#include "sdr_connection.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <optional>
+#include <algorithm>
+
+using namespace sdr;
+
+namespace {
+
+constexpr uint32_t BATCH = 64;
+
+// The table before the lock-free version: every lookup takes the mutex
+class MutexTable {
+public:
+    MessageContext* allocate(uint32_t msg_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = table_[msg_id];
+        if (slot) {
+            retired_.push_back(std::move(slot)); // Readers use contexts after unlocking; keep them alive
+        }
+        slot = std::make_unique<MessageContext>();
+        slot->msg_id = msg_id;
+        slot->init_lifecycle(next_generation_++);
+        slot->activate();
+        return slot.get();
+    }
+
+    void complete(uint32_t msg_id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (table_[msg_id]) {
+            table_[msg_id]->close(MessageState::DEAD);
+        }
+    }
+
+    MessageContext* get(uint32_t msg_id) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto& slot = table_[msg_id];
+        if (!slot || slot->state() == MessageState::NULL_STATE) {
+            return nullptr;
+        }
+        return slot.get();
+    }
+
+private:
+    std::array<std::unique_ptr<MessageContext>, 1024> table_;
+    std::vector<std::unique_ptr<MessageContext>> retired_;
+    mutable std::mutex mutex_;
+    uint32_t next_generation_{1};
+};
+
+// Lookups per second (and accepted lookups, so the work cannot be elided)
+struct RunResult {
+    double lookups_per_sec;
+    uint64_t accepted;
+};
+
+template <typename Lookup, typename Recycle>
+RunResult run(uint32_t readers, uint32_t messages, uint32_t ms, uint32_t writer_period_us,
+              bool pin, Lookup&& lookup, Recycle&& recycle) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> accepted{0};
+    std::vector<std::thread> threads;
+
+    for (uint32_t t = 0; t < readers; ++t) {
+        threads.emplace_back([&, t] {
+            uint64_t n = 0;
+            uint64_t ok = 0;
+            uint32_t id = t * 7;
+            while (!stop.load(std::memory_order_relaxed)) {
+                std::optional<EpochDomain::Guard> guard;
+                if (pin) guard.emplace(EpochDomain::instance());
+                for (uint32_t i = 0; i < BATCH; ++i) {
+                    id = (id + 1) % messages;
+                    MessageContext* ctx = lookup(id);
+                    if (ctx && ctx->accepts(ctx->generation())) {
+                        ok++;
+                    }
+                }
+                n += BATCH;
+            }
+            total.fetch_add(n);
+            accepted.fetch_add(ok);
+        });
+    }
+
+    std::thread writer([&] {
+        uint32_t id = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            recycle(id);
+            id = (id + 1) % messages;
+            std::this_thread::sleep_for(std::chrono::microseconds(writer_period_us));
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    stop.store(true);
+    for (auto& th : threads) th.join();
+    writer.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return RunResult{total.load() / seconds, accepted.load()};
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t ms = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 500;
+    uint32_t messages = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 64;
+    uint32_t writer_period_us = argc > 3 ? static_cast<uint32_t>(std::stoul(argv[3])) : 100;
+    messages = std::max<uint32_t>(1, std::min<uint32_t>(messages, 1024));
+
+    std::cout << "[Bench] " << ms << " ms per run, " << messages << " active messages, slot recycled every "
+              << writer_period_us << " us, " << std::thread::hardware_concurrency() << " CPUs" << std::endl;
+    std::cout << std::setw(8) << "readers" << std::setw(18) << "mutex Mlookup/s"
+              << std::setw(18) << "epoch Mlookup/s" << std::setw(10) << "speedup" << std::endl;
+
+    for (uint32_t readers : {1u, 2u, 4u, 8u, 16u}) {
+        MutexTable legacy;
+        for (uint32_t id = 0; id < messages; ++id) {
+            legacy.allocate(id);
+        }
+        RunResult locked = run(readers, messages, ms, writer_period_us, false,
+            [&](uint32_t id) { return legacy.get(id); },
+            [&](uint32_t id) { legacy.complete(id); legacy.allocate(id); });
+
+        ConnectionContext table;
+        uint32_t generation = 1;
+        auto post = [&](uint32_t id) {
+            MessageContext* ctx = table.allocate_message_slot(id, generation++);
+            if (ctx) table.activate_message(ctx);
+        };
+        for (uint32_t id = 0; id < messages; ++id) {
+            post(id);
+        }
+        RunResult lockfree = run(readers, messages, ms, writer_period_us, true,
+            [&](uint32_t id) { return table.get_message(id); },
+            [&](uint32_t id) { table.complete_message(id); post(id); });
+
+        std::cout << std::setw(8) << readers
+                  << std::setw(18) << std::fixed << std::setprecision(1) << locked.lookups_per_sec / 1e6
+                  << std::setw(18) << lockfree.lookups_per_sec / 1e6
+                  << std::setw(9) << std::setprecision(1)
+                  << (locked.lookups_per_sec > 0 ? lockfree.lookups_per_sec / locked.lookups_per_sec : 0.0) << "x";
+        if (locked.accepted == 0 || lockfree.accepted == 0) {
+            std::cout << "  (no lookups accepted)";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "[Bench] Contexts awaiting reclamation: " << EpochDomain::instance().pending() << std::endl;
+    return 0;
+}
@@ -0,0 +1,118 @@
+// Loopback pacing benchmark: loss rate and goodput with and without token-bucket pacing.
+// The receiver has a small socket buffer and spends a fixed time per packet, so an
+// unpaced sender overruns it the way a busy receiver overruns SO_RCVBUF in practice.
+// Usage: sdr_bench_pacing [packets] [mtu_bytes] [rx_ns_per_packet] [rcvbuf_kb]
+#include "sdr_sender.h"
+#include "sdr_pacer.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+using namespace sdr;
+
+int main(int argc, char* argv[]) {
+    uint32_t packets = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 100000;
+    uint32_t mtu_bytes = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 1024;
+    int64_t rx_ns_per_packet = argc > 3 ? std::stoll(argv[3]) : 4000;
+    int rcvbuf_kb = argc > 4 ? std::stoi(argv[4]) : 512;
+
+    int rx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int recv_buf_size = rcvbuf_kb * 1024;
+    setsockopt(rx_fd, SOL_SOCKET, SO_RCVBUF, &recv_buf_size, sizeof(recv_buf_size));
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (rx_fd < 0 || bind(rx_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        getsockname(rx_fd, (struct sockaddr*)&addr, &addr_len) < 0) {
+        std::cerr << "[Bench] Failed to set up receiver socket: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    struct timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = 20000;
+    setsockopt(rx_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    uint16_t port = ntohs(addr.sin_port);
+
+    // Drain thread: receive, then busy-wait rx_ns_per_packet to model placement/processing cost
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> received{0};
+    std::atomic<int64_t> last_rx_ns{0};
+    std::thread drain([&] {
+        std::vector<uint8_t> buf(sizeof(SDRPacketHeader) + mtu_bytes);
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (recv(rx_fd, buf.data(), buf.size(), 0) > 0) {
+                int64_t until = TokenBucket::now_ns() + rx_ns_per_packet;
+                while (TokenBucket::now_ns() < until) {
+                }
+                received.fetch_add(1, std::memory_order_relaxed);
+                last_rx_ns.store(TokenBucket::now_ns(), std::memory_order_relaxed);
+            }
+        }
+    });
+
+    std::vector<uint8_t> payload(static_cast<size_t>(packets) * mtu_bytes, 0xab);
+    double wire_bytes = static_cast<double>(sizeof(SDRPacketHeader) + mtu_bytes);
+    double capacity_mbps = rx_ns_per_packet > 0 ? wire_bytes * 8.0 * 1e3 / rx_ns_per_packet : 0.0;
+
+    std::cout << "[Bench] " << packets << " packets of " << mtu_bytes << " bytes to 127.0.0.1:" << port
+              << ", receiver " << rx_ns_per_packet << " ns/packet (~" << std::fixed << std::setprecision(0)
+              << capacity_mbps << " Mbit/s), SO_RCVBUF " << rcvbuf_kb << " KiB" << std::endl;
+    std::cout << std::setw(12) << "pacing" << std::setw(14) << "send Mbit/s"
+              << std::setw(16) << "goodput Mbit/s" << std::setw(10) << "loss" << std::endl;
+
+    // 0 = unpaced; the rest are fractions of the receiver's capacity
+    const double rate_fractions[] = {0.0, 0.5, 0.8, 0.95, 1.2};
+    for (double fraction : rate_fractions) {
+        auto pacer = std::make_shared<TokenBucket>();
+        uint64_t rate_bytes = static_cast<uint64_t>(capacity_mbps * fraction * 1e6 / 8.0);
+        pacer->set_rate(rate_bytes, 0);
+
+        UDPSender sender;
+        if (!sender.open_channels("127.0.0.1", port, 1)) {
+            std::cerr << "[Bench] Failed to open send socket: " << strerror(sender.last_error()) << std::endl;
+            break;
+        }
+        sender.set_pacer(pacer);
+        sender.builder().set_message(1, 0, 32, mtu_bytes, payload.data(), payload.size());
+
+        // Let the previous run drain completely
+        while (TokenBucket::now_ns() - last_rx_ns.load() < 200 * 1000000LL) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        uint64_t received_before = received.load();
+        int64_t start = TokenBucket::now_ns();
+        size_t sent = sender.send_range(0, packets);
+        int64_t send_end = TokenBucket::now_ns();
+        while (TokenBucket::now_ns() - last_rx_ns.load() < 200 * 1000000LL) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        uint64_t delivered = received.load() - received_before;
+        double send_secs = (send_end - start) / 1e9;
+        double rx_secs = (std::max(last_rx_ns.load(), send_end) - start) / 1e9;
+        double loss = sent ? 100.0 * (1.0 - static_cast<double>(delivered) / sent) : 0.0;
+        std::string label = fraction == 0.0 ? "unpaced"
+                                            : std::to_string(static_cast<int>(fraction * 100)) + "% cap";
+        std::cout << std::setw(12) << label
+                  << std::setw(14) << std::setprecision(0) << sent * wire_bytes * 8.0 / 1e6 / send_secs
+                  << std::setw(16) << delivered * wire_bytes * 8.0 / 1e6 / rx_secs
+                  << std::setw(9) << std::setprecision(1) << loss << "%" << std::endl;
+    }
+
+    stop.store(true);
+    drain.join();
+    close(rx_fd);
+    return 0;
+}
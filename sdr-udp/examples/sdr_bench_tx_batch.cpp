@@ -0,0 +1,89 @@
+// Loopback transmit benchmark: packets/sec against sendmmsg batch size.
+// Usage: sdr_bench_tx_batch [packets] [mtu_bytes]
+#include "sdr_sender.h"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+using namespace sdr;
+
+int main(int argc, char* argv[]) {
+    uint32_t packets = argc > 1 ? static_cast<uint32_t>(std::stoul(argv[1])) : 200000;
+    uint32_t mtu_bytes = argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : 1024;
+
+    // Receiver socket on an ephemeral loopback port, drained by a background thread
+    int rx_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    int recv_buf_size = 64 * 1024 * 1024;
+    setsockopt(rx_fd, SOL_SOCKET, SO_RCVBUF, &recv_buf_size, sizeof(recv_buf_size));
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addr_len = sizeof(addr);
+    if (rx_fd < 0 || bind(rx_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        getsockname(rx_fd, (struct sockaddr*)&addr, &addr_len) < 0) {
+        std::cerr << "[Bench] Failed to set up receiver socket: " << strerror(errno) << std::endl;
+        return 1;
+    }
+    struct timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = 100000;
+    setsockopt(rx_fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    uint16_t port = ntohs(addr.sin_port);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> received{0};
+    std::thread drain([&] {
+        std::vector<uint8_t> buf(sizeof(SDRPacketHeader) + mtu_bytes);
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (recv(rx_fd, buf.data(), buf.size(), 0) > 0) {
+                received.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    std::vector<uint8_t> payload(static_cast<size_t>(packets) * mtu_bytes, 0xab);
+
+    std::cout << "[Bench] " << packets << " packets of " << mtu_bytes << " bytes to 127.0.0.1:" << port << std::endl;
+    std::cout << std::setw(8) << "batch" << std::setw(14) << "pkts/sec"
+              << std::setw(12) << "Gbit/s" << std::setw(12) << "delivered" << std::endl;
+
+    const uint32_t batch_sizes[] = {1, 4, 16, 32, 64, 128, 256};
+    for (uint32_t batch : batch_sizes) {
+        UDPSender sender(batch);
+        if (!sender.open_channels("127.0.0.1", port, 1)) {
+            std::cerr << "[Bench] Failed to open send socket: " << strerror(sender.last_error()) << std::endl;
+            break;
+        }
+        sender.builder().set_message(1, 0, 32, mtu_bytes, payload.data(), payload.size());
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(200)); // let the drain catch up
+        uint64_t received_before = received.load();
+        auto start = std::chrono::steady_clock::now();
+        size_t sent = sender.send_range(0, packets);
+        auto end = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        double secs = std::chrono::duration<double>(end - start).count();
+        double pps = sent / secs;
+        double gbps = pps * (sizeof(SDRPacketHeader) + mtu_bytes) * 8.0 / 1e9;
+        double delivered = sent ? 100.0 * (received.load() - received_before) / sent : 0.0;
+        std::cout << std::setw(8) << batch << std::setw(14) << std::fixed << std::setprecision(0) << pps
+                  << std::setw(12) << std::setprecision(2) << gbps
+                  << std::setw(11) << std::setprecision(1) << delivered << "%" << std::endl;
+    }
+
+    stop.store(true);
+    drain.join();
+    close(rx_fd);
+    return 0;
+}
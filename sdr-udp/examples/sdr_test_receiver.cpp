@@ -101,6 +101,16 @@ int main(int argc, char* argv[]) {
     std::strncpy(params.udp_server_ip, ip_cfg.c_str(), sizeof(params.udp_server_ip) - 1);
     params.udp_server_ip[sizeof(params.udp_server_ip) - 1] = '\0';
     params.transfer_id = config.get_uint32("transfer_id", 1);
+    params.rx_batch_size = config.get_uint32("rx_batch_size", 0);
+    params.rx_direct_placement = config.get_uint32("rx_direct_placement", 1);
+    params.rx_completion_poll_us = config.get_uint32("rx_completion_poll_us", 0);
+    params.rx_shared_engine = config.get_uint32("rx_shared_engine", 0);
+    params.pacing_rate = static_cast<uint64_t>(config.get_uint32("pacing_rate_mbps", 0)) * 1000000 / 8;
+    params.udp_offload = (config.get_uint32("udp_gso", 1) ? UDP_OFFLOAD_GSO : 0) |
+                         (config.get_uint32("udp_gro", 0) ? UDP_OFFLOAD_GRO : 0);
+    params.packet_headers = (config.get_uint32("wide_headers", 0) ? PACKET_HEADER_WIDE : 0) |
+                            (config.get_uint32("compact_headers", 1) ? PACKET_HEADER_COMPACT : 0) |
+                            (config.get_uint32("payload_crc", 0) ? PACKET_HEADER_CRC32C : 0);
     
     std::cout << "[Receiver] Applied config: mtu_bytes=" << params.mtu_bytes 
               << ", packets_per_chunk=" << params.packets_per_chunk
@@ -127,6 +137,7 @@ int main(int argc, char* argv[]) {
         sr_cfg.rto_ms = config.get_uint32("sr_rto_ms", 0);
         sr_cfg.nack_delay_ms = config.get_uint32("sr_nack_delay_ms", 0);
         sr_cfg.max_inflight_chunks = static_cast<uint16_t>(config.get_uint32("sr_max_inflight_chunks", 0));
+        sr_cfg.bitmap_fragments = static_cast<uint16_t>(config.get_uint32("sr_bitmap_fragments", 4));
         sr_receiver.emplace(sr_cfg);
         if (sr_receiver->post_receive(conn, recv_buffer.data(), message_size) != 0) {
             std::cerr << "[Receiver] SR post_receive failed\n";
@@ -370,7 +381,16 @@ int main(int argc, char* argv[]) {
             }
         }
     
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // Sleep until a chunk completes (or the display tick), then consume the completions
+        auto* wait_ctx = load_handle_ctx();
+        if (wait_ctx && wait_ctx->frontend_bitmap) {
+            uint32_t completed[256];
+            wait_ctx->frontend_bitmap->wait_for_completion(10);
+            while (wait_ctx->frontend_bitmap->drain_completions(completed, 256) == 256) {
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
     }
     
     if (iterations >= MAX_ITERATIONS) {
@@ -422,7 +442,7 @@ int main(int argc, char* argv[]) {
                 active_handle->msg_ctx->frontend_bitmap->stop_polling();
             }
             if (active_handle->msg_ctx) {
-                active_handle->msg_ctx->state = MessageState::COMPLETED;
+                active_handle->msg_ctx->close(MessageState::COMPLETED);
             }
         }
         // Always signal completion on the control path so the sender can unblock.
@@ -11,6 +11,8 @@
 using namespace sdr;
 using sdr::reliability::SRSender;
 using sdr::reliability::SRConfig;
+using sdr::reliability::CCAlgorithm;
+using sdr::reliability::cc_algorithm_name;
 using sdr::reliability::ECSender;
 using sdr::reliability::ECConfig;
 
@@ -98,6 +100,12 @@ int main(int argc, char* argv[]) {
     preferred.udp_server_port = static_cast<uint16_t>(udp_port);
     preferred.num_channels = static_cast<uint16_t>(cfg.get_uint32("num_channels", 1));
     preferred.transfer_id = cfg.get_uint32("transfer_id", 1);
+    preferred.tx_batch_size = cfg.get_uint32("tx_batch_size", 0);
+    preferred.tx_threads = cfg.get_uint32("tx_threads", 1);
+    preferred.tx_pin_cores = cfg.get_uint32("tx_pin_cores", 0);
+    preferred.pacing_rate = static_cast<uint64_t>(cfg.get_uint32("pacing_rate_mbps", 0)) * 1000000 / 8;
+    preferred.pacing_burst = cfg.get_uint32("pacing_burst", 0);
+    preferred.udp_offload = cfg.get_uint32("udp_gso", 0) ? UDP_OFFLOAD_GSO : 0;
     sdr_set_params(conn, &preferred);
 
     std::cout << "[Sender] Sending message..." << std::endl;
@@ -109,7 +117,18 @@ int main(int argc, char* argv[]) {
         SRConfig sr_cfg{};
         sr_cfg.rto_ms = cfg.get_uint32("sr_rto_ms", 500);
         sr_cfg.nack_delay_ms = cfg.get_uint32("sr_nack_delay_ms", 200);
+        sr_cfg.min_rto_ms = cfg.get_uint32("sr_min_rto_ms", 1);
+        sr_cfg.max_rto_ms = cfg.get_uint32("sr_max_rto_ms", 10000);
         sr_cfg.max_inflight_chunks = static_cast<uint16_t>(cfg.get_uint32("window_size", 0));
+        std::string cc_name = cfg.get_string("sr_congestion_control", "none");
+        if (cc_name == "aimd") {
+            sr_cfg.cc = CCAlgorithm::AIMD;
+        } else if (cc_name == "delay") {
+            sr_cfg.cc = CCAlgorithm::DELAY;
+        } else if (cc_name != "none") {
+            std::cerr << "[Sender][SR] Unknown sr_congestion_control '" << cc_name << "', using none\n";
+        }
+        sr_cfg.initial_cwnd_chunks = cfg.get_uint32("sr_initial_cwnd", 10);
         SRSender sr_sender(sr_cfg);
         rc = sr_sender.start_send(conn, send_buffer.data(), message_size);
         if (rc == 0) {
@@ -125,7 +144,23 @@ int main(int argc, char* argv[]) {
                   << " (acks=" << sr_sender.stats().acks_sent
                   << ", nacks=" << sr_sender.stats().nacks_sent
                   << ", retrans=" << sr_sender.stats().retransmits
+                  << ", retrans_packets=" << sr_sender.stats().packets_retransmitted
                   << ", throughput=" << throughput_mbps << " Mbps)\n";
+        const auto& st = sr_sender.stats();
+        if (st.rtt_samples > 0) {
+            std::cout << "[Sender][SR] RTT p50/p99 <= " << st.rtt_hist.percentile_us(50) << "/"
+                      << st.rtt_hist.percentile_us(99) << " us, srtt " << st.srtt_us
+                      << " us, rttvar " << st.rttvar_us << " us, rto " << st.rto_us
+                      << " us (p99 <= " << st.rto_hist.percentile_us(99) << " us), "
+                      << st.rto_timeouts << " timeout(s)\n";
+        }
+        if (sr_cfg.cc != CCAlgorithm::NONE) {
+            std::cout << "[Sender][SR] Congestion control " << cc_algorithm_name(sr_cfg.cc)
+                      << ": cwnd=" << st.cwnd_chunks << " chunks"
+                      << ", rate=" << st.pacing_rate * 8 / 1e6 << " Mbps"
+                      << ", rtt samples=" << st.rtt_samples
+                      << " (min " << st.min_rtt_us << " us, srtt " << st.srtt_us << " us)\n";
+        }
         start_time = end_time; // so common footer uses same duration
     } else if (mode == Mode::EC) {
         ECConfig ec_cfg{};
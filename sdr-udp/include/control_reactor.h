@@ -0,0 +1,164 @@
+#pragma once
+
+#include "tcp_control.h"
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sdr {
+
+// Control-plane event loop
+// One epoll thread per process reads every registered control socket and runs
+// one-shot timers (a timerfd in the same epoll set). Each socket's bytes are
+// framed into ControlMessages and handed to its callback on the loop thread, so
+// control threads no longer block in recv() per connection. Callbacks must not
+// block; they may schedule timers and remove sockets.
+class ControlReactor {
+public:
+    using MessageHandler = std::function<void(const ControlMessage&)>;
+    using CloseHandler = std::function<void()>;
+    using TimerCallback = std::function<void()>;
+
+    // The process-wide reactor, created on first use
+    static std::shared_ptr<ControlReactor> acquire();
+
+    ControlReactor();
+    ~ControlReactor();
+
+    ControlReactor(const ControlReactor&) = delete;
+    ControlReactor& operator=(const ControlReactor&) = delete;
+
+    bool is_running() const { return epoll_fd_ >= 0; }
+
+    // Deliver complete messages read from fd until EOF or error, then call on_close
+    // once. The fd stays owned by the caller and may stay blocking for sends.
+    bool add_socket(int fd, MessageHandler on_message, CloseHandler on_close);
+    // Stop watching fd; once this returns no callback for it is running or will run
+    void remove_socket(int fd);
+
+    // Run callback on the loop thread after delay; returns an id for cancel_timer
+    uint64_t schedule(std::chrono::microseconds delay, TimerCallback callback);
+    void cancel_timer(uint64_t timer_id);
+
+    bool on_loop_thread() const { return std::this_thread::get_id() == loop_thread_.get_id(); }
+
+private:
+    struct Socket {
+        MessageHandler on_message;
+        CloseHandler on_close;
+        std::vector<uint8_t> partial;   // Received bytes not yet framed into a message
+        std::atomic<bool> removed{false};
+    };
+
+    struct Timer {
+        std::chrono::steady_clock::time_point deadline;
+        uint64_t id;
+        bool operator>(const Timer& other) const { return deadline > other.deadline; }
+    };
+
+    int epoll_fd_;
+    int wake_fd_;                    // eventfd: wakes the loop to stop
+    int timer_fd_;
+    std::thread loop_thread_;
+    bool stop_;
+
+    std::mutex mutex_;
+    std::condition_variable dispatch_cv_;
+    std::unordered_map<int, std::shared_ptr<Socket>> sockets_;
+    int dispatching_fd_;                 // Socket whose callbacks are running, -1 if none
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timer_heap_;
+    std::unordered_map<uint64_t, TimerCallback> timers_;
+    uint64_t next_timer_id_;
+
+    void loop();
+    void read_socket(int fd);
+    void run_due_timers();
+    void arm_timer_locked();
+};
+
+// Round-trip times of control exchanges that have a reply (OFFER -> CTS, CTS -> ACCEPT),
+// timed from the send to the reply's arrival on the loop thread
+struct ControlRttStats {
+    uint64_t samples{0};
+    uint32_t last_us{0};
+    uint32_t min_us{0};
+    uint32_t srtt_us{0};             // EWMA, 1/8 gain
+};
+
+// Inbox of one control socket, fed by the reactor
+// Messages go to a per-type callback if one is registered, else to a pending
+// expectation, else into the inbox. An expectation (next_of) resolves with the
+// first message of one of its types and discards other types it passes over,
+// as the blocking loops it replaces did; it resolves empty on timeout or close.
+class ControlChannel : public std::enable_shared_from_this<ControlChannel> {
+public:
+    using Handler = std::function<void(const ControlMessage&)>;
+    using Result = std::optional<ControlMessage>;
+
+    static std::shared_ptr<ControlChannel> attach(std::shared_ptr<ControlReactor> reactor, int fd,
+                                                  const char* log_tag);
+    ~ControlChannel();
+
+    // Stop reading the socket (the caller closes it afterwards)
+    void detach();
+    bool closed() const;
+
+    // Next message of any of the given types (empty list = any type); timeout 0 = none.
+    // Only one expectation is outstanding: a newer one resolves the older one empty.
+    std::future<Result> next_of(std::initializer_list<ControlMsgType> types,
+                                std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    // Blocking wrapper: false on timeout or close
+    bool receive(ControlMessage& msg, std::chrono::milliseconds timeout);
+
+    // Run handler on the loop thread for every message of this type (null removes it)
+    void on_message(ControlMsgType type, Handler handler);
+
+    // Record a send so its reply can be timed
+    void note_sent(ControlMsgType type);
+    ControlRttStats rtt_stats() const;
+
+private:
+    ControlChannel(std::shared_ptr<ControlReactor> reactor, int fd, const char* log_tag);
+
+    struct Expectation {
+        uint32_t type_mask;
+        std::promise<Result> promise;
+        uint64_t seq;
+        uint64_t timer_id;
+    };
+
+    static uint32_t type_bit(ControlMsgType type) { return 1u << (static_cast<uint32_t>(type) & 31); }
+
+    std::shared_ptr<ControlReactor> reactor_;
+    int fd_;
+    const char* log_tag_;
+    mutable std::mutex mutex_;
+    std::deque<ControlMessage> inbox_;
+    std::optional<Expectation> pending_;
+    uint64_t next_seq_;
+    bool closed_;
+    bool attached_;
+    std::unordered_map<uint32_t, Handler> handlers_;
+    std::unordered_map<uint32_t, std::chrono::steady_clock::time_point> awaiting_reply_;  // Keyed by reply type
+    ControlRttStats rtt_;
+
+    void deliver(const ControlMessage& msg);
+    void on_close();
+    void expire(uint64_t seq);
+    void record_reply_locked(ControlMsgType type);
+};
+
+} // namespace sdr
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "tcp_control.h"
+#include "control_reactor.h"
 #include "sdr_connection.h"
 #include "sdr_receiver.h"
+#include "sdr_rx_engine.h"
+#include "sdr_sender.h"
+#include "sdr_tx_engine.h"
 #include "sdr_backend.h"
 #include "sdr_frontend.h"
 #include <cstdint>
@@ -32,6 +36,10 @@ struct SDRContext {
 struct SDRConnection {
     std::shared_ptr<ConnectionContext> connection_ctx;
     std::shared_ptr<UDPReceiver> udp_receiver;
+    std::shared_ptr<RXEngine> rx_engine;    // Receiver side: shared engine when rx_shared_engine is set
+    std::shared_ptr<UDPSender> udp_sender;  // Sender side: shared by all data paths
+    std::shared_ptr<TXEngine> tx_engine;    // Sender side: initial send when tx_threads > 1
+    std::shared_ptr<TokenBucket> pacer;     // Sender side: shared by every data path of the connection
     SDRContext* parent_ctx;           // Back-reference to context (non-owning)
     TCPControlServer* tcp_server;    // Owned by receiver side
     TCPControlClient* tcp_client;    // Owned by sender side
@@ -76,6 +84,7 @@ struct SDRStreamHandle {
     size_t total_packets;
     size_t packets_sent;
     bool is_active;
+    SDRConnection* conn;
 };
 
 // Public API Functions
@@ -90,6 +99,12 @@ SDRConnection* sdr_connect(SDRContext* ctx, const char* server_ip, uint16_t tcp_
 
 SDRConnection* sdr_listen(SDRContext* ctx, uint16_t tcp_port);
 
+// Block until a sender connects to a listening connection and return a new
+// receiver connection for that sender. Sessions share the listener's TCP socket
+// and the process-wide RXEngine (rx_shared_engine is forced on), start from the
+// listener's parameters, and are disconnected independently of it.
+SDRConnection* sdr_accept(SDRConnection* listener);
+
 void sdr_disconnect(SDRConnection* conn);
 
 // Connection parameter configuration (set before recv_post/send_post)
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <atomic>
 #include <memory>
+#include <algorithm>
 
 namespace sdr {
 
@@ -10,16 +11,23 @@ class BackendBitmap {
 public:
     BackendBitmap(uint32_t total_packets, uint16_t packets_per_chunk);
     
-    bool set_packet_received(uint32_t packet_offset);
+    // Returns true if the packet was newly set. chunk_completed (optional) is set
+    // when this packet was the last one missing from its chunk.
+    bool set_packet_received(uint32_t packet_offset, bool* chunk_completed = nullptr);
     
     bool is_packet_received(uint32_t packet_offset) const;
     
     bool is_chunk_complete(uint32_t chunk_id) const;
     
+    // Progress queries read counters maintained on every newly set bit: O(1)
     uint32_t get_chunk_packet_count(uint32_t chunk_id) const;
     
     uint32_t get_total_packets_received() const;
     
+    // Exact snapshots recounted from the bitmap words with popcount: O(words)
+    uint32_t count_chunk_packets_exact(uint32_t chunk_id) const;
+    uint32_t count_packets_received_exact() const;
+    
     // Get packet bitmap snapshot (for frontend polling)
     // Returns pointer to internal bitmap (read-only, thread-safe for reading)
     const std::atomic<uint64_t>* get_packet_bitmap() const {
@@ -37,12 +45,40 @@ public:
     
     uint32_t get_total_packets() const { return total_packets_; }
     uint16_t get_packets_per_chunk() const { return packets_per_chunk_; }
+    uint32_t get_total_chunks() const { return total_chunks_; }
+    
+    // Number of packets in a chunk (the last chunk may be short)
+    uint32_t get_chunk_size(uint32_t chunk_id) const;
+    
+    // Dirty-word summary: one bit per packet-bitmap word, set when a packet in
+    // that word arrives, so a scanner only revisits words touched since its last
+    // pass. Off until enabled (enabling marks every word dirty once).
+    void enable_dirty_tracking();
+    uint32_t get_dirty_summary_size() const { return num_summary_words_; }
+    // Atomically take and clear one summary word
+    uint64_t take_dirty_summary(uint32_t summary_idx);
+    
+    // Mask of bits [lo, hi) within a word (0 <= lo < hi <= 64)
+    static uint64_t range_mask(uint32_t lo, uint32_t hi) {
+        uint64_t upper = hi >= 64 ? ~0ULL : ((1ULL << hi) - 1);
+        return upper & (~0ULL << lo);
+    }
     
 private:
     std::unique_ptr<std::atomic<uint64_t>[]> packet_bitmap_;
     uint32_t num_words_;  // Number of uint64_t words in bitmap
     uint32_t total_packets_;
     uint16_t packets_per_chunk_;
+    uint32_t total_chunks_;
+    
+    // Packets received per chunk, bumped once per newly set bit; the packet that
+    // brings a chunk to its size completes it without any rescan
+    std::unique_ptr<std::atomic<uint32_t>[]> chunk_packet_counts_;
+    std::atomic<uint32_t> total_received_;
+    
+    std::unique_ptr<std::atomic<uint64_t>[]> dirty_summary_;
+    uint32_t num_summary_words_;
+    std::atomic<bool> track_dirty_;
     
     // Helper: check if all packets in chunk range are set
     bool check_chunk_range(uint32_t chunk_start_packet, uint32_t chunk_end_packet) const;
@@ -50,7 +86,8 @@ private:
 
 // Implementation
 inline BackendBitmap::BackendBitmap(uint32_t total_packets, uint16_t packets_per_chunk)
-    : total_packets_(total_packets), packets_per_chunk_(packets_per_chunk) {
+    : total_packets_(total_packets), packets_per_chunk_(packets_per_chunk),
+      total_received_(0), track_dirty_(false) {
     // Allocate enough uint64_t words to hold all packet bits
     // Each uint64_t holds 64 bits
     num_words_ = (total_packets + 63) / 64;
@@ -62,9 +99,57 @@ inline BackendBitmap::BackendBitmap(uint32_t total_packets, uint16_t packets_per
     for (uint32_t i = 0; i < num_words_; ++i) {
         packet_bitmap_[i].store(0, std::memory_order_relaxed);
     }
+    
+    total_chunks_ = packets_per_chunk_ ? (total_packets + packets_per_chunk_ - 1) / packets_per_chunk_ : 0;
+    chunk_packet_counts_ = std::make_unique<std::atomic<uint32_t>[]>(total_chunks_);
+    for (uint32_t i = 0; i < total_chunks_; ++i) {
+        chunk_packet_counts_[i].store(0, std::memory_order_relaxed);
+    }
+    
+    num_summary_words_ = (num_words_ + 63) / 64;
+    dirty_summary_ = std::make_unique<std::atomic<uint64_t>[]>(num_summary_words_);
+    for (uint32_t i = 0; i < num_summary_words_; ++i) {
+        dirty_summary_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+inline void BackendBitmap::enable_dirty_tracking() {
+    if (track_dirty_.exchange(true, std::memory_order_seq_cst)) {
+        return;
+    }
+    // Words set before tracking started have no summary bit yet
+    for (uint32_t i = 0; i < num_summary_words_; ++i) {
+        uint32_t words_here = std::min<uint32_t>(64, num_words_ - i * 64);
+        dirty_summary_[i].fetch_or(range_mask(0, words_here), std::memory_order_release);
+    }
+}
+
+inline uint64_t BackendBitmap::take_dirty_summary(uint32_t summary_idx) {
+    if (summary_idx >= num_summary_words_) {
+        return 0;
+    }
+    // Plain load first: clean summary words are the common case and need no RMW
+    if (dirty_summary_[summary_idx].load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+    uint64_t dirty = dirty_summary_[summary_idx].exchange(0, std::memory_order_seq_cst);
+    // Packet bits set before a writer saw the summary bit still set are visible below
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return dirty;
+}
+
+inline uint32_t BackendBitmap::get_chunk_size(uint32_t chunk_id) const {
+    if (chunk_id >= total_chunks_) {
+        return 0;
+    }
+    uint32_t chunk_start_packet = chunk_id * packets_per_chunk_;
+    return std::min<uint32_t>(packets_per_chunk_, total_packets_ - chunk_start_packet);
 }
 
-inline bool BackendBitmap::set_packet_received(uint32_t packet_offset) {
+inline bool BackendBitmap::set_packet_received(uint32_t packet_offset, bool* chunk_completed) {
+    if (chunk_completed) {
+        *chunk_completed = false;
+    }
     if (packet_offset >= total_packets_) {
         return false;
     }
@@ -75,10 +160,36 @@ inline bool BackendBitmap::set_packet_received(uint32_t packet_offset) {
     // Atomically set the bit using fetch_or
     // Returns old value, so if bit was already set, old_value will have that bit set
     uint64_t bit_mask = 1ULL << bit_pos;
-    uint64_t old_value = packet_bitmap_[word_idx].fetch_or(bit_mask, std::memory_order_release);
+    // seq_cst (free on x86, where the RMW is a full barrier) so the dirty-summary
+    // check below cannot miss a concurrent take_dirty_summary()
+    uint64_t old_value = packet_bitmap_[word_idx].fetch_or(bit_mask, std::memory_order_seq_cst);
     
     // Return true if bit was newly set (wasn't set before)
-    return (old_value & bit_mask) == 0;
+    if ((old_value & bit_mask) != 0) {
+        return false;
+    }
+    
+    if (track_dirty_.load(std::memory_order_relaxed)) {
+        std::atomic<uint64_t>& summary = dirty_summary_[word_idx / 64];
+        uint64_t summary_bit = 1ULL << (word_idx % 64);
+        // Skip the RMW while the scanner has not consumed the word yet
+        if ((summary.load(std::memory_order_seq_cst) & summary_bit) == 0) {
+            summary.fetch_or(summary_bit, std::memory_order_release);
+        }
+    }
+    
+    total_received_.fetch_add(1, std::memory_order_relaxed);
+    
+    if (total_chunks_ > 0) {
+        // acq_rel chains every writer of the chunk, so whoever sees the final count
+        // also sees all of the chunk's payload
+        uint32_t chunk_id = packet_offset / packets_per_chunk_;
+        uint32_t count = chunk_packet_counts_[chunk_id].fetch_add(1, std::memory_order_acq_rel) + 1;
+        if (chunk_completed && count == get_chunk_size(chunk_id)) {
+            *chunk_completed = true;
+        }
+    }
+    return true;
 }
 
 inline bool BackendBitmap::is_packet_received(uint32_t packet_offset) const {
@@ -108,35 +219,46 @@ inline bool BackendBitmap::is_chunk_complete(uint32_t chunk_id) const {
 }
 
 inline uint32_t BackendBitmap::get_chunk_packet_count(uint32_t chunk_id) const {
+    if (chunk_id >= total_chunks_) {
+        return total_chunks_ == 0 ? count_chunk_packets_exact(chunk_id) : 0;
+    }
+    return chunk_packet_counts_[chunk_id].load(std::memory_order_acquire);
+}
+
+inline uint32_t BackendBitmap::get_total_packets_received() const {
+    return total_received_.load(std::memory_order_acquire);
+}
+
+inline uint32_t BackendBitmap::count_chunk_packets_exact(uint32_t chunk_id) const {
     uint32_t chunk_start_packet = chunk_id * packets_per_chunk_;
-    uint32_t chunk_end_packet = chunk_start_packet + packets_per_chunk_;
-    
-    if (chunk_end_packet > total_packets_) {
-        chunk_end_packet = total_packets_;
+    uint32_t chunk_end_packet = std::min<uint32_t>(chunk_start_packet + packets_per_chunk_, total_packets_);
+    if (packets_per_chunk_ == 0 || chunk_start_packet >= chunk_end_packet) {
+        return 0;
     }
     
+    uint32_t start_word = chunk_start_packet / 64;
+    uint32_t end_word = (chunk_end_packet - 1) / 64;
     uint32_t count = 0;
-    for (uint32_t i = chunk_start_packet; i < chunk_end_packet; ++i) {
-        if (is_packet_received(i)) {
-            count++;
-        }
+    for (uint32_t word = start_word; word <= end_word; ++word) {
+        uint32_t lo = word == start_word ? chunk_start_packet % 64 : 0;
+        uint32_t hi = word == end_word ? (chunk_end_packet - 1) % 64 + 1 : 64;
+        uint64_t value = packet_bitmap_[word].load(std::memory_order_acquire);
+        count += static_cast<uint32_t>(__builtin_popcountll(value & range_mask(lo, hi)));
     }
     return count;
 }
 
-inline uint32_t BackendBitmap::get_total_packets_received() const {
+inline uint32_t BackendBitmap::count_packets_received_exact() const {
+    // Bits past total_packets_ are never set, so whole words can be counted
     uint32_t count = 0;
-    for (uint32_t i = 0; i < total_packets_; ++i) {
-        if (is_packet_received(i)) {
-            count++;
-        }
+    for (uint32_t word = 0; word < num_words_; ++word) {
+        count += static_cast<uint32_t>(__builtin_popcountll(packet_bitmap_[word].load(std::memory_order_acquire)));
     }
     return count;
 }
 
 inline bool BackendBitmap::check_chunk_range(uint32_t chunk_start_packet, uint32_t chunk_end_packet) const {
-    // Check if all packets in the range are set
-    // We can optimize by checking whole words when possible
+    // Check if all packets in the range are set, a whole word at a time
     
     uint32_t start_word, start_bit;
     get_bit_position(chunk_start_packet, start_word, start_bit);
@@ -145,44 +267,30 @@ inline bool BackendBitmap::check_chunk_range(uint32_t chunk_start_packet, uint32
     get_bit_position(chunk_end_packet - 1, end_word, end_bit);
     end_bit++; // Make it exclusive
     
-    // Check if all words between start and end have all bits set
     if (start_word == end_word) {
         // All packets in same word
-        uint64_t mask = 0;
-        for (uint32_t bit = start_bit; bit < end_bit; ++bit) {
-            mask |= (1ULL << bit);
-        }
-        
+        uint64_t mask = range_mask(start_bit, end_bit);
         uint64_t value = packet_bitmap_[start_word].load(std::memory_order_acquire);
         return (value & mask) == mask;
-    } else {
-        // Span multiple words
-        // Check first word (partial)
-        uint64_t first_mask = 0;
-        for (uint32_t bit = start_bit; bit < 64; ++bit) {
-            first_mask |= (1ULL << bit);
-        }
-        uint64_t first_value = packet_bitmap_[start_word].load(std::memory_order_acquire);
-        if ((first_value & first_mask) != first_mask) {
+    }
+    
+    // Span multiple words: partial first word, full middle words, partial last word
+    uint64_t first_mask = range_mask(start_bit, 64);
+    uint64_t first_value = packet_bitmap_[start_word].load(std::memory_order_acquire);
+    if ((first_value & first_mask) != first_mask) {
+        return false;
+    }
+    
+    for (uint32_t word = start_word + 1; word < end_word; ++word) {
+        uint64_t value = packet_bitmap_[word].load(std::memory_order_acquire);
+        if (value != UINT64_MAX) {
             return false;
         }
-        
-        // Check middle words (should be all 1s)
-        for (uint32_t word = start_word + 1; word < end_word; ++word) {
-            uint64_t value = packet_bitmap_[word].load(std::memory_order_acquire);
-            if (value != UINT64_MAX) {
-                return false;
-            }
-        }
-        
-        // Check last word (partial)
-        uint64_t last_mask = 0;
-        for (uint32_t bit = 0; bit < end_bit; ++bit) {
-            last_mask |= (1ULL << bit);
-        }
-        uint64_t last_value = packet_bitmap_[end_word].load(std::memory_order_acquire);
-        return (last_value & last_mask) == last_mask;
     }
+    
+    uint64_t last_mask = range_mask(0, end_bit);
+    uint64_t last_value = packet_bitmap_[end_word].load(std::memory_order_acquire);
+    return (last_value & last_mask) == last_mask;
 }
 
 } // namespace sdr
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define SDR_BITMAP_X86 1
+#endif
+
+namespace sdr::bitmap {
+
+// Word-level kernels over plain uint64_t bitmaps (bit i = word i / 64, bit i % 64),
+// shared by the frontend, SR and EC. Bit scans use count-trailing/leading-zero
+// builtins (tzcnt/lzcnt when built with BMI); on x86 the multi-word loops
+// (skipping full or empty words, popcount, OR-merge) have AVX2 versions picked
+// at runtime, with a scalar fallback. Bits at or past nbits are ignored.
+
+enum class Isa : uint8_t {
+    SCALAR = 0,
+    AVX2 = 1,
+};
+
+// A run of zero bits: [start, start + len)
+struct Gap {
+    uint32_t start;
+    uint32_t len;
+};
+
+inline const char* isa_name(Isa isa) {
+    return isa == Isa::AVX2 ? "avx2" : "scalar";
+}
+
+namespace detail {
+
+inline bool cpu_has_avx2() {
+#ifdef SDR_BITMAP_X86
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+inline Isa& active() {
+    static Isa isa = cpu_has_avx2() ? Isa::AVX2 : Isa::SCALAR;
+    return isa;
+}
+
+inline bool use_avx2(uint32_t words) {
+    return words >= 4 && active() == Isa::AVX2;
+}
+
+inline uint64_t low_mask(uint32_t bits) {
+    return bits >= 64 ? ~0ULL : ((1ULL << bits) - 1);
+}
+
+inline uint32_t words_for(uint32_t nbits) {
+    return (nbits + 63) / 64;
+}
+
+#ifdef SDR_BITMAP_X86
+// Index of the first of words[w, end) that is not all ones (skip == ~0) or not
+// all zeros (skip == 0); end if none
+__attribute__((target("avx2")))
+inline uint32_t skip_words_avx2(const uint64_t* words, uint32_t w, uint32_t end, uint64_t skip) {
+    const __m256i pattern = _mm256_set1_epi64x(static_cast<long long>(skip));
+    for (; w + 4 <= end; w += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + w));
+        uint32_t same = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, pattern))));
+        if (same != 0xF) {
+            return w + static_cast<uint32_t>(__builtin_ctz(~same & 0xF));
+        }
+    }
+    for (; w < end && words[w] == skip; ++w) {
+    }
+    return w;
+}
+
+// Nibble-lookup popcount (Mula): per-byte counts from pshufb, summed with SAD
+__attribute__((target("avx2")))
+inline uint64_t popcount_words_avx2(const uint64_t* words, uint32_t count) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    uint32_t w = 0;
+    for (; w + 4 <= count; w += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + w));
+        __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+        __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+    }
+    uint64_t total = static_cast<uint64_t>(_mm256_extract_epi64(acc, 0)) +
+                     static_cast<uint64_t>(_mm256_extract_epi64(acc, 1)) +
+                     static_cast<uint64_t>(_mm256_extract_epi64(acc, 2)) +
+                     static_cast<uint64_t>(_mm256_extract_epi64(acc, 3));
+    for (; w < count; ++w) {
+        total += static_cast<uint64_t>(__builtin_popcountll(words[w]));
+    }
+    return total;
+}
+
+__attribute__((target("avx2")))
+inline void or_merge_avx2(uint64_t* dst, const uint64_t* src, uint32_t count) {
+    uint32_t w = 0;
+    for (; w + 4 <= count; w += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + w));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + w));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + w), _mm256_or_si256(a, b));
+    }
+    for (; w < count; ++w) {
+        dst[w] |= src[w];
+    }
+}
+#endif
+
+inline uint32_t skip_words(const uint64_t* words, uint32_t w, uint32_t end, uint64_t skip) {
+    // Short runs are the common case at high loss: check a few words before the
+    // (non-inlinable) vector loop
+    for (uint32_t probe = 0; probe < 4; ++probe, ++w) {
+        if (w >= end || words[w] != skip) {
+            return w;
+        }
+    }
+#ifdef SDR_BITMAP_X86
+    if (use_avx2(end - w)) {
+        return skip_words_avx2(words, w, end, skip);
+    }
+#endif
+    for (; w < end && words[w] == skip; ++w) {
+    }
+    return w;
+}
+
+// First bit >= from whose value is `value`, nbits if none
+inline uint32_t find_first(const uint64_t* words, uint32_t nbits, uint32_t from, bool value) {
+    if (from >= nbits) {
+        return nbits;
+    }
+    const uint64_t skip = value ? 0 : ~0ULL;
+    const uint32_t end = words_for(nbits);
+    uint32_t w = from / 64;
+    // Flip so the wanted bits are ones, and drop the bits below `from`
+    uint64_t word = (words[w] ^ skip) & (~0ULL << (from % 64));
+    if (word == 0) {
+        w = skip_words(words, w + 1, end, skip);
+        if (w >= end) {
+            return nbits;
+        }
+        word = words[w] ^ skip;
+    }
+    uint32_t bit = w * 64 + static_cast<uint32_t>(__builtin_ctzll(word));
+    return std::min(bit, nbits);
+}
+
+} // namespace detail
+
+// Kernel set in use; AVX2 by default where the CPU has it
+inline Isa active_isa() {
+    return detail::active();
+}
+
+// Override the dispatch (benchmarks); returns false if the CPU lacks the ISA
+inline bool set_isa(Isa isa) {
+    if (isa == Isa::AVX2 && !detail::cpu_has_avx2()) {
+        return false;
+    }
+    detail::active() = isa;
+    return true;
+}
+
+// First clear bit at or after `from`; nbits if every bit is set
+inline uint32_t find_first_zero(const uint64_t* words, uint32_t nbits, uint32_t from = 0) {
+    return detail::find_first(words, nbits, from, false);
+}
+
+// First set bit at or after `from`; nbits if none
+inline uint32_t find_first_set(const uint64_t* words, uint32_t nbits, uint32_t from = 0) {
+    return detail::find_first(words, nbits, from, true);
+}
+
+// Last set bit below nbits; nbits if none
+inline uint32_t find_last_set(const uint64_t* words, uint32_t nbits) {
+    for (uint32_t w = detail::words_for(nbits); w-- > 0;) {
+        uint64_t word = words[w];
+        if (w == nbits / 64) {
+            word &= detail::low_mask(nbits % 64);
+        }
+        if (word != 0) {
+            return w * 64 + 63 - static_cast<uint32_t>(__builtin_clzll(word));
+        }
+    }
+    return nbits;
+}
+
+// Number of set bits below nbits
+inline uint32_t popcount(const uint64_t* words, uint32_t nbits) {
+    const uint32_t full = nbits / 64;
+    uint64_t count = 0;
+#ifdef SDR_BITMAP_X86
+    if (detail::use_avx2(full)) {
+        count = detail::popcount_words_avx2(words, full);
+    } else
+#endif
+    {
+        for (uint32_t w = 0; w < full; ++w) {
+            count += static_cast<uint64_t>(__builtin_popcountll(words[w]));
+        }
+    }
+    if (nbits % 64) {
+        count += static_cast<uint64_t>(__builtin_popcountll(words[full] & detail::low_mask(nbits % 64)));
+    }
+    return static_cast<uint32_t>(count);
+}
+
+// dst |= src over `count` words
+inline void or_merge(uint64_t* dst, const uint64_t* src, uint32_t count) {
+#ifdef SDR_BITMAP_X86
+    if (detail::use_avx2(count)) {
+        detail::or_merge_avx2(dst, src, count);
+        return;
+    }
+#endif
+    for (uint32_t w = 0; w < count; ++w) {
+        dst[w] |= src[w];
+    }
+}
+
+// Runs of clear bits in one pass, in order, up to max_gaps. Full and empty words
+// are skipped whole. Returns the number of gaps written; 0 means every bit is set,
+// and otherwise gaps[0].start is the length of the all-set prefix.
+inline size_t extract_gaps(const uint64_t* words, uint32_t nbits, Gap* gaps, size_t max_gaps) {
+    const uint32_t end = detail::words_for(nbits);
+    size_t n = 0;
+    bool in_gap = false;
+    uint32_t gap_start = 0;
+    uint32_t w = 0;
+    uint64_t lower = ~0ULL;   // Bits of words[w] not yet consumed
+    while (w < end && n < max_gaps) {
+        // Outside a gap look for the next clear bit, inside it for the next set bit
+        const uint64_t flip = in_gap ? 0 : ~0ULL;
+        uint64_t word = (words[w] ^ flip) & lower;
+        if (word == 0) {
+            w = detail::skip_words(words, w + 1, end, flip);
+            lower = ~0ULL;
+            continue;
+        }
+        uint32_t bit = static_cast<uint32_t>(__builtin_ctzll(word));
+        uint32_t pos = w * 64 + bit;
+        if (pos >= nbits) {
+            break;
+        }
+        if (in_gap) {
+            gaps[n++] = Gap{gap_start, pos - gap_start};
+        } else {
+            gap_start = pos;
+        }
+        in_gap = !in_gap;
+        lower = ~0ULL << bit;   // The bit at pos now has the unwanted value
+    }
+    if (in_gap && n < max_gaps) {
+        gaps[n++] = Gap{gap_start, nbits - gap_start};
+    }
+    return n;
+}
+
+// Call fn(bit) for each set bit below nbits, in order
+template <typename Fn>
+inline void for_each_set_bit(const uint64_t* words, uint32_t nbits, Fn&& fn) {
+    const uint32_t end = detail::words_for(nbits);
+    for (uint32_t w = 0; w < end; ++w) {
+        uint64_t word = words[w];
+        if (w == nbits / 64) {
+            word &= detail::low_mask(nbits % 64);
+        }
+        while (word) {
+            fn(w * 64 + static_cast<uint32_t>(__builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+}
+
+} // namespace sdr::bitmap
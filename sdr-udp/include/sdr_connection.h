@@ -3,6 +3,8 @@
 #include "sdr_backend.h"
 #include "sdr_frontend.h"
 #include "tcp_control.h"
+#include "sdr_epoch.h"
+#include "sdr_packet.h"
 #include <cstdint>
 #include <memory>
 #include <array>
@@ -10,22 +12,35 @@
 #include <atomic>
 #include <cstring>
 #include <vector>
+#include <thread>
 
 namespace sdr {
 
+// Data header layout a CTS grants (ConnectionParams::packet_headers)
+inline HeaderFormat negotiated_header_format(const ConnectionParams& params) {
+    if (params.packet_headers & PACKET_HEADER_COMPACT) {
+        return HeaderFormat::COMPACT;
+    }
+    return (params.packet_headers & PACKET_HEADER_WIDE) ? HeaderFormat::WIDE : HeaderFormat::STANDARD;
+}
+
 // Message state
 enum class MessageState : uint8_t {
     ACTIVE = 0,      // Message is active and receiving packets
     COMPLETED = 1,   // Message has been completed
-    DEAD = 2,        // Message is completed and protected with null sink
+    DEAD = 2,        // Message is completed; late packets are dropped
     NULL_STATE = 3   // Message slot is null (unused)
 };
 
 // Message context (per message)
+// Generation, writer count and state share one atomic lifecycle word, so a
+// receive worker validates a packet with a single acquire load. Workers that
+// write into the buffer hold a writer reference (begin_write/end_write), which
+// is only granted while the message is ACTIVE for the packet's generation;
+// close() leaves ACTIVE and waits for the references to drain, after which
+// nothing writes the buffer again and the slot can be reused.
 struct MessageContext {
     uint32_t msg_id;                // Message identifier (0-1023)
-    uint32_t generation;             // Generation number (for late packet protection)
-    MessageState state;              // Current state
     
     void* buffer;                    // User receive buffer
     size_t buffer_size;              // Buffer size in bytes
@@ -40,12 +55,87 @@ struct MessageContext {
     // Connection parameters
     ConnectionParams connection_params;
     
+    // Packets dropped for a CRC32C mismatch (PACKET_HEADER_CRC32C); left for SR/EC to repair
+    std::atomic<uint64_t> packets_corrupt{0};
+    
     MessageContext()
-        : msg_id(0), generation(0), state(MessageState::NULL_STATE),
-          buffer(nullptr), buffer_size(0), total_packets(0), total_chunks(0),
-          packets_per_chunk(0) {
+        : msg_id(0), buffer(nullptr), buffer_size(0), total_packets(0), total_chunks(0),
+          packets_per_chunk(0), lifecycle_(pack(0, 0, MessageState::NULL_STATE)) {
         memset(&connection_params, 0, sizeof(connection_params));
     }
+    
+    // Generation number (late packet protection); fixed when the slot is allocated
+    uint32_t generation() const {
+        return word_generation(lifecycle_.load(std::memory_order_acquire));
+    }
+    
+    MessageState state() const {
+        return word_state(lifecycle_.load(std::memory_order_acquire));
+    }
+    
+    // True if a packet of this generation may be written (one acquire load).
+    // generation_mask selects the bits a packet header carries (compact headers
+    // send only the low bits).
+    bool accepts(uint32_t generation, uint32_t generation_mask = UINT32_MAX) const {
+        uint64_t word = lifecycle_.load(std::memory_order_acquire);
+        return (word_generation(word) & generation_mask) == generation && word_state(word) == MessageState::ACTIVE;
+    }
+    
+    // Take a writer reference for a packet of this generation; fails once the
+    // message is closed or the generation is stale
+    bool begin_write(uint32_t generation, uint32_t generation_mask = UINT32_MAX) {
+        uint64_t word = lifecycle_.load(std::memory_order_acquire);
+        do {
+            if ((word_generation(word) & generation_mask) != generation || word_state(word) != MessageState::ACTIVE) {
+                return false;
+            }
+        } while (!lifecycle_.compare_exchange_weak(word, word + WRITER_ONE,
+                                                   std::memory_order_acquire, std::memory_order_acquire));
+        return true;
+    }
+    
+    // Release: this writer's buffer and bitmap stores happen before close() returns
+    void end_write() {
+        lifecycle_.fetch_sub(WRITER_ONE, std::memory_order_release);
+    }
+    
+    // Move to a terminal state (COMPLETED or DEAD) and wait for in-flight writers.
+    // New writers are refused from the moment the state changes.
+    void close(MessageState final_state) {
+        uint64_t word = lifecycle_.load(std::memory_order_relaxed);
+        while (!lifecycle_.compare_exchange_weak(word, (word & ~STATE_MASK) | static_cast<uint64_t>(final_state),
+                                                 std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        }
+        while (word_writers(lifecycle_.load(std::memory_order_acquire)) != 0) {
+            std::this_thread::yield();
+        }
+    }
+    
+    // Allocation (before publication) and activation by ConnectionContext
+    void init_lifecycle(uint32_t generation) {
+        lifecycle_.store(pack(generation, 0, MessageState::NULL_STATE), std::memory_order_relaxed);
+    }
+    void activate() {
+        // No writers exist before ACTIVE; release publishes the buffer and bitmaps
+        uint64_t word = lifecycle_.load(std::memory_order_relaxed);
+        lifecycle_.store(pack(word_generation(word), 0, MessageState::ACTIVE), std::memory_order_release);
+    }
+    
+private:
+    // Lifecycle word: generation << 32 | writers << 8 | state
+    static constexpr uint64_t STATE_MASK = 0xFF;
+    static constexpr uint64_t WRITER_ONE = 1ULL << 8;
+    static constexpr uint64_t WRITER_MASK = 0xFFFFFFULL << 8;
+    
+    static uint64_t pack(uint32_t generation, uint32_t writers, MessageState state) {
+        return (static_cast<uint64_t>(generation) << 32) | (static_cast<uint64_t>(writers) << 8) |
+               static_cast<uint64_t>(state);
+    }
+    static uint32_t word_generation(uint64_t word) { return static_cast<uint32_t>(word >> 32); }
+    static uint32_t word_writers(uint64_t word) { return static_cast<uint32_t>((word & WRITER_MASK) >> 8); }
+    static MessageState word_state(uint64_t word) { return static_cast<MessageState>(word & STATE_MASK); }
+    
+    std::atomic<uint64_t> lifecycle_;
 };
 
 // Connection context (per connection)
@@ -56,10 +146,17 @@ public:
     
     bool initialize(uint32_t connection_id, const ConnectionParams& params);
     
+    // The new context is in the table but invisible to get_message (NULL_STATE)
+    // until the caller has filled it in and calls activate_message
     MessageContext* allocate_message_slot(uint32_t msg_id, uint32_t generation);
+    void activate_message(MessageContext* msg_ctx);
+    // Wait-free. The context stays valid while the caller holds an EpochDomain
+    // guard (receive workers) or owns the message (the posting thread).
     MessageContext* get_message(uint32_t msg_id) const;
     void release_message(uint32_t msg_id);
 
+    // Close the message (DEAD): later packets are dropped, and in-flight writes
+    // finish before this returns
     void complete_message(uint32_t msg_id);
     
     void set_tcp_socket(int tcp_fd) { tcp_socket_fd_ = tcp_fd; }
@@ -69,6 +166,10 @@ public:
     
     uint32_t get_connection_id() const { return connection_id_; }
     const ConnectionParams& get_params() const { return params_; }
+    // Data header layout granted in CTS
+    HeaderFormat header_format() const { return negotiated_header_format(params_); }
+    // Packets carry a CRC32C (granted in CTS)
+    bool payload_crc() const { return (params_.packet_headers & PACKET_HEADER_CRC32C) != 0; }
     
     bool is_initialized() const { return is_initialized_; }
 
@@ -85,12 +186,12 @@ private:
     bool is_initialized_;
     bool auto_send_data_;
     
-    // Message table: fixed-size array indexed by msg_id (0-1023)
+    // Message table: fixed-size array indexed by msg_id (0-1023). Readers load the
+    // pointers lock-free; writers serialize on the mutex, publish with seq_cst stores
+    // and hand replaced contexts to the EpochDomain instead of deleting them.
     static constexpr size_t MAX_MESSAGES = 1024;
-    std::array<std::unique_ptr<MessageContext>, MAX_MESSAGES> msg_table_;
-    mutable std::mutex msg_table_mutex_;  // Protects message table
-    std::vector<uint8_t> null_sink_;      // Single-byte null sink for late packets
-    std::array<uint32_t, MAX_MESSAGES> generation_counters_{}; // rotating generations per msg_id
+    std::array<std::atomic<MessageContext*>, MAX_MESSAGES> msg_table_;
+    std::mutex msg_table_mutex_;          // Serializes table writers
     
     // Socket file descriptors
     int tcp_socket_fd_;
@@ -102,14 +203,17 @@ inline ConnectionContext::ConnectionContext()
     : connection_id_(0), is_initialized_(false), auto_send_data_(true),
       tcp_socket_fd_(-1), udp_socket_fd_(-1) {
     memset(&params_, 0, sizeof(params_));
-    null_sink_.resize(1, 0);
-    generation_counters_.fill(1); // start generations at 1
+    for (auto& slot : msg_table_) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+    EpochDomain::instance(); // Constructed first so it outlives this context
 }
 
 inline ConnectionContext::~ConnectionContext() {
     std::lock_guard<std::mutex> lock(msg_table_mutex_);
-    for (auto& msg : msg_table_) {
-        msg.reset();
+    EpochDomain& epochs = EpochDomain::instance();
+    for (auto& slot : msg_table_) {
+        epochs.retire(slot.exchange(nullptr, std::memory_order_seq_cst));
     }
 }
 
@@ -130,27 +234,35 @@ inline MessageContext* ConnectionContext::allocate_message_slot(uint32_t msg_id,
     
     std::lock_guard<std::mutex> lock(msg_table_mutex_);
     
-    auto& msg_ptr = msg_table_[msg_id];
+    MessageContext* old_ctx = msg_table_[msg_id].load(std::memory_order_relaxed);
     // Allow reuse if slot is NULL or DEAD/COMPLETED with older generation.
     // Reject if slot is ACTIVE (transfer in progress) or generation is not newer.
-    if (msg_ptr && msg_ptr->state == MessageState::ACTIVE) {
-        return nullptr;
-    }
-
-    if (msg_ptr && (msg_ptr->state == MessageState::COMPLETED || msg_ptr->state == MessageState::DEAD)
-        && msg_ptr->generation >= generation) {
-        return nullptr;
+    if (old_ctx) {
+        MessageState old_state = old_ctx->state();
+        if (old_state == MessageState::ACTIVE) {
+            return nullptr;
+        }
+        if ((old_state == MessageState::COMPLETED || old_state == MessageState::DEAD)
+            && old_ctx->generation() >= generation) {
+            return nullptr;
+        }
     }
     
-    msg_ptr = std::make_unique<MessageContext>();
-    // Rotate generation to avoid late packet corruption
-    uint32_t rotated_gen = generation_counters_[msg_id]++;
-    msg_ptr->msg_id = msg_id;
-    msg_ptr->generation = rotated_gen;
-    msg_ptr->state = MessageState::ACTIVE;
-    msg_ptr->connection_params = params_;
+    // A closed message has no writers left, so the slot can take the new generation.
+    // The caller's generation is what the sender stamps on packets (CTS transfer_id).
+    auto msg_ctx = std::make_unique<MessageContext>();
+    msg_ctx->msg_id = msg_id;
+    msg_ctx->init_lifecycle(generation);
+    msg_ctx->connection_params = params_;
     
-    return msg_ptr.get();
+    // Workers still holding the old context keep it until they unpin
+    MessageContext* published = msg_ctx.release();
+    EpochDomain::instance().retire(msg_table_[msg_id].exchange(published, std::memory_order_seq_cst));
+    return published;
+}
+
+inline void ConnectionContext::activate_message(MessageContext* msg_ctx) {
+    msg_ctx->activate();
 }
 
 inline MessageContext* ConnectionContext::get_message(uint32_t msg_id) const {
@@ -158,14 +270,12 @@ inline MessageContext* ConnectionContext::get_message(uint32_t msg_id) const {
         return nullptr;
     }
     
-    std::lock_guard<std::mutex> lock(msg_table_mutex_);
-    const auto& msg_ptr = msg_table_[msg_id];
-    
-    if (!msg_ptr || msg_ptr->state == MessageState::NULL_STATE) {
+    MessageContext* msg_ctx = msg_table_[msg_id].load(std::memory_order_acquire);
+    if (!msg_ctx || msg_ctx->state() == MessageState::NULL_STATE) {
         return nullptr;
     }
     
-    return msg_ptr.get();
+    return msg_ctx;
 }
 
 inline void ConnectionContext::release_message(uint32_t msg_id) {
@@ -174,7 +284,11 @@ inline void ConnectionContext::release_message(uint32_t msg_id) {
     }
     
     std::lock_guard<std::mutex> lock(msg_table_mutex_);
-    msg_table_[msg_id].reset();
+    MessageContext* msg_ctx = msg_table_[msg_id].exchange(nullptr, std::memory_order_seq_cst);
+    if (msg_ctx) {
+        msg_ctx->close(MessageState::DEAD);
+    }
+    EpochDomain::instance().retire(msg_ctx);
 }
 
 inline void ConnectionContext::complete_message(uint32_t msg_id) {
@@ -183,11 +297,11 @@ inline void ConnectionContext::complete_message(uint32_t msg_id) {
     }
     
     std::lock_guard<std::mutex> lock(msg_table_mutex_);
-    auto& msg_ptr = msg_table_[msg_id];
+    MessageContext* msg_ctx = msg_table_[msg_id].load(std::memory_order_relaxed);
     
-    if (msg_ptr) {
-        msg_ptr->state = MessageState::DEAD;
-        msg_ptr->buffer = null_sink_.data(); // Redirect to null sink to avoid late-packet corruption
+    if (msg_ctx) {
+        // Late packets are refused from here on; returns once in-flight writes are done
+        msg_ctx->close(MessageState::DEAD);
     }
 }
 
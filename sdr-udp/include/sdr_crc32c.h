@@ -0,0 +1,193 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define SDR_CRC32C_X86 1
+#endif
+
+namespace sdr::crc32c {
+
+// CRC32C (Castagnoli, reflected polynomial 0x82F63B78), as in iSCSI and ext4.
+// On x86 with SSE4.2 and PCLMULQDQ the crc32 instruction runs over three
+// interleaved lanes, hiding its 3-cycle latency, and carry-less multiplies fold
+// the lanes together; the scalar fallback is slicing-by-8 over a table built at
+// compile time. The kernel is picked at runtime.
+
+enum class Isa : uint8_t {
+    SCALAR = 0,
+    SSE42 = 1,
+};
+
+inline const char* isa_name(Isa isa) {
+    return isa == Isa::SSE42 ? "sse4.2" : "scalar";
+}
+
+namespace detail {
+
+constexpr uint32_t POLY = 0x82F63B78;
+
+// Lane lengths of the three-way kernel: long blocks for bulk data, short ones so
+// 1 KiB packets still interleave
+constexpr size_t LONG_LANE = 2048;
+constexpr size_t SHORT_LANE = 128;
+
+struct Tables {
+    uint32_t t[8][256];
+};
+
+constexpr Tables make_tables() {
+    Tables tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; ++k) {
+            crc = (crc & 1) ? (crc >> 1) ^ POLY : crc >> 1;
+        }
+        tables.t[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        for (int s = 1; s < 8; ++s) {
+            uint32_t prev = tables.t[s - 1][i];
+            tables.t[s][i] = (prev >> 8) ^ tables.t[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+inline constexpr Tables TABLES = make_tables();
+
+// x^n mod P, bit-reflected
+constexpr uint32_t xpow(uint32_t n) {
+    uint32_t v = 0x80000000u;
+    for (uint32_t i = 0; i < n; ++i) {
+        v = (v & 1) ? (v >> 1) ^ POLY : v >> 1;
+    }
+    return v;
+}
+
+// Multipliers that advance a lane's CRC past len bytes of the lanes after it:
+// crc32(0, clmul(crc, x^(8 len - 33))) = crc * x^(8 len) mod P
+constexpr uint32_t shift_key(size_t len) {
+    return xpow(static_cast<uint32_t>(8 * len - 33));
+}
+
+// Raw CRC register update (no pre/post inversion)
+inline uint32_t update_scalar(uint32_t crc, const uint8_t* p, size_t len) {
+    const auto& t = TABLES.t;
+    for (; len >= 8; p += 8, len -= 8) {
+        uint32_t lo, hi;
+        std::memcpy(&lo, p, sizeof(lo));
+        std::memcpy(&hi, p + 4, sizeof(hi));
+        lo ^= crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+    }
+    for (; len > 0; ++p, --len) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xFF];
+    }
+    return crc;
+}
+
+#ifdef SDR_CRC32C_X86
+inline bool cpu_has_sse42() {
+    static const bool supported = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul");
+    return supported;
+}
+
+__attribute__((target("sse4.2,pclmul")))
+inline uint32_t clmul_shift(uint32_t crc, uint32_t key) {
+    __m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128(static_cast<int>(crc)),
+                                           _mm_cvtsi32_si128(static_cast<int>(key)), 0);
+    return static_cast<uint32_t>(_mm_crc32_u64(0, static_cast<uint64_t>(_mm_cvtsi128_si64(product))));
+}
+
+// Whole blocks of three lanes of `lane` bytes; returns the bytes consumed
+template <size_t lane>
+__attribute__((target("sse4.2,pclmul")))
+inline size_t update_lanes(uint32_t& crc, const uint8_t* p, size_t len) {
+    constexpr uint32_t key1 = shift_key(lane);
+    constexpr uint32_t key2 = shift_key(2 * lane);
+    size_t done = 0;
+    for (; len - done >= 3 * lane; done += 3 * lane) {
+        const uint8_t* block = p + done;
+        uint64_t c0 = crc, c1 = 0, c2 = 0;
+        for (size_t i = 0; i < lane; i += 8) {
+            uint64_t w0, w1, w2;
+            std::memcpy(&w0, block + i, sizeof(w0));
+            std::memcpy(&w1, block + lane + i, sizeof(w1));
+            std::memcpy(&w2, block + 2 * lane + i, sizeof(w2));
+            c0 = _mm_crc32_u64(c0, w0);
+            c1 = _mm_crc32_u64(c1, w1);
+            c2 = _mm_crc32_u64(c2, w2);
+        }
+        crc = clmul_shift(static_cast<uint32_t>(c0), key2) ^ clmul_shift(static_cast<uint32_t>(c1), key1) ^
+              static_cast<uint32_t>(c2);
+    }
+    return done;
+}
+
+__attribute__((target("sse4.2,pclmul")))
+inline uint32_t update_sse42(uint32_t crc, const uint8_t* p, size_t len) {
+    size_t done = update_lanes<LONG_LANE>(crc, p, len);
+    done += update_lanes<SHORT_LANE>(crc, p + done, len - done);
+    p += done;
+    len -= done;
+    uint64_t c = crc;
+    for (; len >= 8; p += 8, len -= 8) {
+        uint64_t w;
+        std::memcpy(&w, p, sizeof(w));
+        c = _mm_crc32_u64(c, w);
+    }
+    crc = static_cast<uint32_t>(c);
+    for (; len > 0; ++p, --len) {
+        crc = _mm_crc32_u8(crc, *p);
+    }
+    return crc;
+}
+#else
+inline bool cpu_has_sse42() {
+    return false;
+}
+#endif
+
+inline Isa& active() {
+    static Isa isa = cpu_has_sse42() ? Isa::SSE42 : Isa::SCALAR;
+    return isa;
+}
+
+} // namespace detail
+
+// Kernel in use; SSE4.2 by default where the CPU has it (and PCLMULQDQ)
+inline Isa active_isa() {
+    return detail::active();
+}
+
+// Override the dispatch (benchmarks); returns false if the CPU lacks the ISA
+inline bool set_isa(Isa isa) {
+    if (isa == Isa::SSE42 && !detail::cpu_has_sse42()) {
+        return false;
+    }
+    detail::active() = isa;
+    return true;
+}
+
+// Continue the CRC32C `crc` of earlier bytes over len more; extend(0, ...) starts one
+inline uint32_t extend(uint32_t crc, const void* data, size_t len) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+#ifdef SDR_CRC32C_X86
+    if (detail::active() == Isa::SSE42) {
+        return ~detail::update_sse42(~crc, p, len);
+    }
+#endif
+    return ~detail::update_scalar(~crc, p, len);
+}
+
+inline uint32_t compute(const void* data, size_t len) {
+    return extend(0, data, len);
+}
+
+} // namespace sdr::crc32c
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace sdr {
+
+// Epoch-based reclamation for tables that are read on the receive hot path and
+// written rarely. Readers pin the current epoch for the duration of a read-side
+// section (wait-free: a thread-local slot store and a fence); writers unlink an
+// object, retire it, and it is freed once every pinned reader has moved two
+// epochs past the retirement. Objects are only safe to dereference while pinned.
+class EpochDomain {
+public:
+    static constexpr size_t MAX_READERS = 256;
+
+    // Process-wide domain shared by all connections
+    static EpochDomain& instance() {
+        static EpochDomain domain;
+        return domain;
+    }
+
+    // RAII read-side section; nests within a thread
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& domain) : domain_(&domain) { domain_->enter(); }
+        ~Guard() {
+            if (domain_) domain_->exit();
+        }
+        Guard(Guard&& other) noexcept : domain_(other.domain_) { other.domain_ = nullptr; }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        Guard& operator=(Guard&&) = delete;
+
+    private:
+        EpochDomain* domain_;
+    };
+
+    Guard pin() { return Guard(*this); }
+
+    // Hand an object unlinked with a seq_cst store/exchange to the domain; it is
+    // deleted once no reader can hold it
+    template <typename T>
+    void retire(T* object) {
+        if (!object) {
+            return;
+        }
+        retire(object, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    void retire(void* object, void (*deleter)(void*)) {
+        {
+            std::lock_guard<std::mutex> lock(limbo_mutex_);
+            // Read after the caller's unlink (seq_cst), so readers pinned later cannot see the object
+            limbo_.push_back(Retired{object, deleter, epoch_.load(std::memory_order_seq_cst)});
+        }
+        reclaim();
+    }
+
+    // Advance the epoch if all readers allow it and free what became unreachable;
+    // returns the number of objects freed
+    size_t reclaim() {
+        try_advance();
+        try_advance();
+        uint64_t safe_before = epoch_.load(std::memory_order_acquire);
+        std::vector<Retired> ready;
+        {
+            std::lock_guard<std::mutex> lock(limbo_mutex_);
+            auto keep = limbo_.begin();
+            for (auto it = limbo_.begin(); it != limbo_.end(); ++it) {
+                if (it->epoch + 2 <= safe_before) {
+                    ready.push_back(*it);
+                } else {
+                    *keep++ = *it;
+                }
+            }
+            limbo_.erase(keep, limbo_.end());
+        }
+        for (const Retired& r : ready) {
+            r.deleter(r.object);
+        }
+        return ready.size();
+    }
+
+    size_t pending() const {
+        std::lock_guard<std::mutex> lock(limbo_mutex_);
+        return limbo_.size();
+    }
+
+    ~EpochDomain() {
+        // Process exit: no readers remain
+        for (const Retired& r : limbo_) {
+            r.deleter(r.object);
+        }
+    }
+
+private:
+    struct Retired {
+        void* object;
+        void (*deleter)(void*);
+        uint64_t epoch;
+    };
+
+    // Per-thread announcement: (epoch << 1) | pinned
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> state{0};
+        std::atomic<bool> in_use{false};
+    };
+
+    // Thread-local registration, released when the thread exits
+    struct ThreadRecord {
+        EpochDomain* domain{nullptr};
+        Slot* slot{nullptr};
+        uint32_t depth{0};
+        bool overflow{false};
+        ~ThreadRecord() {
+            if (slot) {
+                slot->state.store(0, std::memory_order_release);
+                slot->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    EpochDomain() = default;
+
+    ThreadRecord& record() {
+        static thread_local ThreadRecord rec;
+        if (rec.domain != this) {
+            rec.domain = this;
+            rec.slot = nullptr;
+            for (Slot& s : slots_) {
+                bool expected = false;
+                if (!s.in_use.load(std::memory_order_relaxed) &&
+                    s.in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                    rec.slot = &s;
+                    break;
+                }
+            }
+        }
+        return rec;
+    }
+
+    void enter() {
+        ThreadRecord& rec = record();
+        if (rec.depth++ > 0) {
+            return;
+        }
+        if (rec.slot) {
+            rec.slot->state.store((epoch_.load(std::memory_order_seq_cst) << 1) | 1, std::memory_order_relaxed);
+            rec.overflow = false;
+        } else {
+            // More reader threads than slots: hold the epoch back as a group
+            overflow_readers_.fetch_add(1, std::memory_order_relaxed);
+            rec.overflow = true;
+        }
+        // Pairs with the fence in try_advance: the announcement is visible before any
+        // table read, and those reads see every unlink ordered before the epoch we took
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void exit() {
+        ThreadRecord& rec = record();
+        if (--rec.depth > 0) {
+            return;
+        }
+        if (rec.overflow) {
+            overflow_readers_.fetch_sub(1, std::memory_order_release);
+        } else {
+            rec.slot->state.store(0, std::memory_order_release);
+        }
+    }
+
+    bool try_advance() {
+        // Pairs with the fence in enter(): a reader not seen pinned here reads the table after our unlink
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t current = epoch_.load(std::memory_order_relaxed);
+        if (overflow_readers_.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+        for (const Slot& s : slots_) {
+            uint64_t state = s.state.load(std::memory_order_acquire);
+            if ((state & 1) && (state >> 1) != current) {
+                return false;
+            }
+        }
+        return epoch_.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+    }
+
+    Slot slots_[MAX_READERS];
+    std::atomic<uint64_t> epoch_{1};
+    std::atomic<uint32_t> overflow_readers_{0};
+    mutable std::mutex limbo_mutex_;
+    std::vector<Retired> limbo_;
+};
+
+} // namespace sdr
@@ -8,11 +8,20 @@
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace sdr {
 
 // Frontend chunk bitmap manager
-// Polls packet bitmap from backend and updates chunk bitmap
+// Chunks are normally marked complete from the receive path: the packet that
+// completes a chunk (BackendBitmap's per-chunk counter) calls mark_chunk_complete,
+// which sets the chunk bit and publishes the chunk id to a completion queue with
+// an eventfd for waiters. The polling thread that rescans the packet bitmap is
+// optional and only needed for backends that set packet bits some other way.
 class FrontendBitmap {
 public:
     FrontendBitmap(std::shared_ptr<BackendBitmap> backend_bitmap, 
@@ -39,14 +48,36 @@ public:
         return num_words_;
     }
     
-    // Get total chunks completed
+    // Copy up to max_words chunk bitmap words into out for the sdr::bitmap kernels;
+    // returns the number of words written
+    uint32_t snapshot_chunk_bitmap(uint64_t* out, uint32_t max_words) const;
+    
+    // Get total chunks completed (maintained counter, O(1))
     uint32_t get_total_chunks_completed() const;
     
+    // Exact recount of the chunk bitmap with popcount, O(words)
+    uint32_t count_chunks_completed_exact() const;
+    
     // Force a polling cycle (for testing/debugging)
     void poll_once();
     
     uint32_t get_total_chunks() const { return total_chunks_; }
     
+    // Mark a chunk complete and publish it to the completion queue; safe from any
+    // thread. Returns true if this call completed the chunk.
+    bool mark_chunk_complete(uint32_t chunk_id);
+    
+    // Completion queue (single consumer). Returns the number of chunk ids written.
+    size_t drain_completions(uint32_t* chunk_ids, size_t max_chunks);
+    
+    // Wait until a completion is queued or timeout_ms passes (-1 = forever).
+    // Returns true if completions are ready to drain.
+    bool wait_for_completion(int timeout_ms);
+    
+    // eventfd that becomes readable when completions are queued, for callers with
+    // their own poll/epoll loop (created on first use; -1 on failure)
+    int completion_fd();
+    
 private:
     std::shared_ptr<BackendBitmap> backend_bitmap_;
     std::unique_ptr<std::atomic<uint64_t>[]> chunk_bitmap_;
@@ -61,6 +92,14 @@ private:
     std::condition_variable poller_cv_;
     uint32_t poll_interval_us_;
     
+    // Completion queue: every chunk completes once, so a ring of total_chunks_
+    // slots never wraps. Producers claim a slot with fetch_add and publish
+    // chunk_id + 1; 0 marks a claimed slot that is not yet written.
+    std::unique_ptr<std::atomic<uint32_t>[]> completion_ring_;
+    std::atomic<uint32_t> completion_tail_;   // Also the number of chunks completed
+    uint32_t completion_head_;           // Consumer only
+    std::atomic<int> event_fd_;
+    
     // Polling thread function
     void polling_thread_func();
     
@@ -78,7 +117,10 @@ inline FrontendBitmap::FrontendBitmap(std::shared_ptr<BackendBitmap> backend_bit
       total_chunks_(total_chunks),
       packets_per_chunk_(backend_bitmap ? backend_bitmap->get_packets_per_chunk() : 0),
       should_stop_(false),
-      poll_interval_us_(100) {
+      poll_interval_us_(100),
+      completion_tail_(0),
+      completion_head_(0),
+      event_fd_(-1) {
     
     // Allocate enough uint64_t words to hold all chunk bits
     num_words_ = (total_chunks + 63) / 64;
@@ -90,10 +132,19 @@ inline FrontendBitmap::FrontendBitmap(std::shared_ptr<BackendBitmap> backend_bit
     for (uint32_t i = 0; i < num_words_; ++i) {
         chunk_bitmap_[i].store(0, std::memory_order_relaxed);
     }
+    
+    completion_ring_ = std::make_unique<std::atomic<uint32_t>[]>(total_chunks_);
+    for (uint32_t i = 0; i < total_chunks_; ++i) {
+        completion_ring_[i].store(0, std::memory_order_relaxed);
+    }
 }
 
 inline FrontendBitmap::~FrontendBitmap() {
     stop_polling();
+    int fd = event_fd_.load(std::memory_order_acquire);
+    if (fd >= 0) {
+        close(fd);
+    }
 }
 
 inline bool FrontendBitmap::start_polling(uint32_t poll_interval_us) {
@@ -103,6 +154,9 @@ inline bool FrontendBitmap::start_polling(uint32_t poll_interval_us) {
     
     poll_interval_us_ = poll_interval_us;
     should_stop_.store(false, std::memory_order_relaxed);
+    if (backend_bitmap_) {
+        backend_bitmap_->enable_dirty_tracking();
+    }
     
     poller_thread_ = std::thread(&FrontendBitmap::polling_thread_func, this);
     return true;
@@ -134,16 +188,30 @@ inline bool FrontendBitmap::is_chunk_complete(uint32_t chunk_id) const {
 }
 
 inline uint32_t FrontendBitmap::get_total_chunks_completed() const {
+    // Every completion claims exactly one ring slot
+    return completion_tail_.load(std::memory_order_acquire);
+}
+
+inline uint32_t FrontendBitmap::snapshot_chunk_bitmap(uint64_t* out, uint32_t max_words) const {
+    uint32_t words = std::min(num_words_, max_words);
+    for (uint32_t i = 0; i < words; ++i) {
+        out[i] = chunk_bitmap_[i].load(std::memory_order_acquire);
+    }
+    return words;
+}
+
+inline uint32_t FrontendBitmap::count_chunks_completed_exact() const {
     uint32_t count = 0;
-    for (uint32_t i = 0; i < total_chunks_; ++i) {
-        if (is_chunk_complete(i)) {
-            count++;
-        }
+    for (uint32_t i = 0; i < num_words_; ++i) {
+        count += static_cast<uint32_t>(__builtin_popcountll(chunk_bitmap_[i].load(std::memory_order_acquire)));
     }
     return count;
 }
 
 inline void FrontendBitmap::poll_once() {
+    if (backend_bitmap_) {
+        backend_bitmap_->enable_dirty_tracking();
+    }
     update_chunk_bitmap();
 }
 
@@ -161,13 +229,24 @@ inline void FrontendBitmap::polling_thread_func() {
 }
 
 inline void FrontendBitmap::update_chunk_bitmap() {
-    if (!backend_bitmap_) {
+    if (!backend_bitmap_ || packets_per_chunk_ == 0 || total_chunks_ == 0) {
         return;
     }
     
-    // Check each chunk and update bitmap if complete
-    for (uint32_t chunk_id = 0; chunk_id < total_chunks_; ++chunk_id) {
-        check_and_set_chunk(chunk_id);
+    // Only chunks overlapping packet words touched since the last pass can have changed
+    const uint32_t summary_words = backend_bitmap_->get_dirty_summary_size();
+    for (uint32_t s = 0; s < summary_words; ++s) {
+        uint64_t dirty = backend_bitmap_->take_dirty_summary(s);
+        while (dirty) {
+            uint32_t word_idx = s * 64 + static_cast<uint32_t>(__builtin_ctzll(dirty));
+            dirty &= dirty - 1;
+            
+            uint32_t first_chunk = word_idx * 64 / packets_per_chunk_;
+            uint32_t last_chunk = std::min<uint32_t>((word_idx * 64 + 63) / packets_per_chunk_, total_chunks_ - 1);
+            for (uint32_t chunk_id = first_chunk; chunk_id <= last_chunk; ++chunk_id) {
+                check_and_set_chunk(chunk_id);
+            }
+        }
     }
 }
 
@@ -182,15 +261,118 @@ inline bool FrontendBitmap::check_and_set_chunk(uint32_t chunk_id) {
         return false;
     }
     
+    return mark_chunk_complete(chunk_id);
+}
+
+inline bool FrontendBitmap::mark_chunk_complete(uint32_t chunk_id) {
+    if (chunk_id >= total_chunks_) {
+        return false;
+    }
+    
     // Mark chunk as complete in chunk bitmap (atomically)
     uint32_t word_idx = chunk_id / 64;
     uint32_t bit_pos = chunk_id % 64;
     uint64_t bit_mask = 1ULL << bit_pos;
     
-    uint64_t old_value = chunk_bitmap_[word_idx].fetch_or(bit_mask, std::memory_order_release);
+    uint64_t old_value = chunk_bitmap_[word_idx].fetch_or(bit_mask, std::memory_order_acq_rel);
+    if ((old_value & bit_mask) != 0) {
+        return false; // Already complete (e.g. the poller got there first)
+    }
     
-    // Return true if we just set it (wasn't set before)
-    return (old_value & bit_mask) == 0;
+    // seq_cst pairs with completion_fd(): either the creator sees this entry or we see the fd
+    uint32_t slot = completion_tail_.fetch_add(1, std::memory_order_relaxed);
+    completion_ring_[slot].store(chunk_id + 1, std::memory_order_seq_cst);
+    
+    int fd = event_fd_.load(std::memory_order_seq_cst);
+    if (fd >= 0) {
+        uint64_t one = 1;
+        ssize_t rc = write(fd, &one, sizeof(one));
+        (void)rc; // EAGAIN only if the counter saturates, which still leaves it readable
+    }
+    return true;
+}
+
+inline size_t FrontendBitmap::drain_completions(uint32_t* chunk_ids, size_t max_chunks) {
+    int fd = event_fd_.load(std::memory_order_acquire);
+    if (fd >= 0) {
+        // Reset before draining: a completion published after this read writes the fd again
+        uint64_t value;
+        ssize_t rc = read(fd, &value, sizeof(value));
+        (void)rc;
+    }
+    
+    size_t n = 0;
+    while (n < max_chunks && completion_head_ < total_chunks_) {
+        uint32_t value = completion_ring_[completion_head_].load(std::memory_order_acquire);
+        if (value == 0) {
+            break; // Not claimed yet, or claimed but not yet published
+        }
+        chunk_ids[n++] = value - 1;
+        completion_head_++;
+    }
+    
+    if (n == max_chunks && fd >= 0 && completion_head_ < total_chunks_ &&
+        completion_ring_[completion_head_].load(std::memory_order_acquire) != 0) {
+        // More left than the caller took: keep the fd readable for the next wait
+        uint64_t one = 1;
+        ssize_t rc = write(fd, &one, sizeof(one));
+        (void)rc;
+    }
+    return n;
+}
+
+inline bool FrontendBitmap::wait_for_completion(int timeout_ms) {
+    auto pending = [this] {
+        return completion_head_ < total_chunks_ &&
+               completion_ring_[completion_head_].load(std::memory_order_acquire) != 0;
+    };
+    if (pending()) {
+        return true;
+    }
+    
+    int fd = completion_fd();
+    if (fd < 0) {
+        return false;
+    }
+    // The fd may have been created after a producer checked for it
+    if (pending()) {
+        return true;
+    }
+    
+    struct pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int ready;
+    do {
+        ready = poll(&pfd, 1, timeout_ms);
+    } while (ready < 0 && errno == EINTR);
+    return pending();
+}
+
+inline int FrontendBitmap::completion_fd() {
+    int fd = event_fd_.load(std::memory_order_acquire);
+    if (fd >= 0) {
+        return fd;
+    }
+    
+    int created = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (created < 0) {
+        return -1;
+    }
+    int expected = -1;
+    if (!event_fd_.compare_exchange_strong(expected, created, std::memory_order_seq_cst)) {
+        close(created);
+        return expected;
+    }
+    // Completions queued before the fd existed did not signal it
+    if (completion_head_ < total_chunks_ &&
+        completion_ring_[completion_head_].load(std::memory_order_seq_cst) != 0) {
+        uint64_t one = 1;
+        ssize_t rc = write(created, &one, sizeof(one));
+        (void)rc;
+    }
+    return created;
 }
 
 } // namespace sdr
@@ -0,0 +1,300 @@
+#pragma once
+
+#include "sdr_packet.h"
+#include "sdr_crc32c.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <endian.h>
+
+namespace sdr::header_codec {
+
+// Explicit wire encoding of the data packet headers
+// Every field has a fixed byte offset and byte order, so hosts of either
+// endianness agree on the wire; nothing depends on how a compiler lays out
+// bitfields. The standard layout is the one x86 senders have always produced
+// from SDRPacketHeader: big-endian fields, except the msg_id/packet_offset word
+// and conn_id, which are little-endian as the bitfields were stored there.
+//
+// Standard (32 bytes):
+//   0  magic 0x5344 (BE16)          14 chunk_seq (BE32)
+//   2  type                         18 packets_per_chunk (BE16)
+//   3  reserved                     20 fec_k, fec_m, parity_idx (BE16 each, unused)
+//   4  transfer_id (BE32)           26 payload_len (BE16)
+//   8  LE32: bits 0-9 msg_id,       28 flags
+//      bits 10-27 packet_offset     29 conn_id (LE24)
+//   12 submsg_id (BE16, unused)
+// With FLAG_CRC32C, bytes 20-23 of either 32-byte layout hold the packet CRC32C
+// (BE32) in place of fec_k/fec_m or the wide chunk_seq.
+// Wide (32 bytes): SDRWideHeader, every field big-endian.
+// Compact (12 bytes): SDRCompactHeader, every field big-endian.
+//
+// decode() reads a header with two to three unaligned 64-bit loads and extracts
+// the fields with shifts and byte swaps; the only branches pick the layout and
+// validate it.
+
+namespace offsets {
+constexpr size_t CRC = 20;   // Both 32-byte layouts
+constexpr size_t STANDARD_OFFSET_WORD = 8;
+constexpr size_t STANDARD_CHUNK_SEQ = 14;
+constexpr size_t STANDARD_PACKETS_PER_CHUNK = 18;
+constexpr size_t STANDARD_PAYLOAD_LEN = 26;
+constexpr size_t STANDARD_FLAGS = 28;
+constexpr size_t STANDARD_CONN_ID = 29;
+constexpr size_t WIDE_FLAGS = 3;
+constexpr size_t WIDE_PACKET_OFFSET = 8;
+constexpr size_t WIDE_MSG_ID = 16;
+constexpr size_t WIDE_CHUNK_SEQ = 20;
+constexpr size_t WIDE_PACKETS_PER_CHUNK = 24;
+constexpr size_t WIDE_PAYLOAD_LEN = 26;
+constexpr size_t WIDE_CONN_ID = 28;
+constexpr size_t COMPACT_FLAGS = 1;
+constexpr size_t COMPACT_PAYLOAD_LEN = 2;
+constexpr size_t COMPACT_MSG_KEY = 4;
+constexpr size_t COMPACT_PACKET_OFFSET = 8;
+} // namespace offsets
+
+static_assert(offsetof(SDRWideHeader, packet_offset) == offsets::WIDE_PACKET_OFFSET &&
+              offsetof(SDRWideHeader, conn_id) == offsets::WIDE_CONN_ID, "SDRWideHeader layout changed");
+static_assert(offsetof(SDRCompactHeader, msg_key) == offsets::COMPACT_MSG_KEY &&
+              offsetof(SDRCompactHeader, packet_offset) == offsets::COMPACT_PACKET_OFFSET,
+              "SDRCompactHeader layout changed");
+
+constexpr uint32_t STANDARD_MSG_ID_BITS = 10;
+constexpr uint32_t STANDARD_OFFSET_MASK = SDRPacketHeader::MAX_PACKETS - 1;
+
+// Fields a sender stamps into a header
+struct HeaderFields {
+    uint8_t type;
+    uint8_t flags;
+    uint32_t transfer_id;
+    uint32_t msg_id;
+    uint32_t packet_offset;
+    uint32_t chunk_seq;
+    uint16_t packets_per_chunk;
+    uint16_t payload_len;
+    uint32_t conn_id;
+};
+
+namespace detail {
+
+inline uint64_t load_le64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return le64toh(v);
+}
+
+inline uint32_t load_be32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return be32toh(v);
+}
+
+inline void store_be16(uint8_t* p, uint16_t v) {
+    v = htobe16(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline void store_be32(uint8_t* p, uint32_t v) {
+    v = htobe32(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline void store_be64(uint8_t* p, uint64_t v) {
+    v = htobe64(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+inline void store_le32(uint8_t* p, uint32_t v) {
+    v = htole32(v);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+// Byte i of a little-endian load is bits 8i..8i+7
+inline uint32_t byte_at(uint64_t word, unsigned i) {
+    return static_cast<uint32_t>(word >> (8 * i)) & 0xFF;
+}
+
+inline uint16_t be16_at(uint64_t word, unsigned i) {
+    return static_cast<uint16_t>(__builtin_bswap16(static_cast<uint16_t>(word >> (8 * i))));
+}
+
+inline uint32_t be32_at(uint64_t word, unsigned i) {
+    return __builtin_bswap32(static_cast<uint32_t>(word >> (8 * i)));
+}
+
+// CRC32C of a 32-byte header with its CRC word left out
+inline uint32_t header_crc(const uint8_t* b) {
+    constexpr size_t after = offsets::CRC + sizeof(uint32_t);
+    return crc32c::extend(crc32c::extend(0, b, offsets::CRC), b + after, sizeof(SDRPacketHeader) - after);
+}
+
+// Only checksummed packets pay for the header CRC
+inline void read_crc(const uint8_t* b, PacketInfo& info) {
+    info.crc32c = 0;
+    info.header_crc = 0;
+    if (info.flags & FLAG_CRC32C) {
+        info.crc32c = load_be32(b + offsets::CRC);
+        info.header_crc = header_crc(b);
+    }
+}
+
+inline bool decode_standard(const uint8_t* b, PacketInfo& info) {
+    const uint64_t w0 = load_le64(b);        // magic, type, reserved, transfer_id
+    const uint64_t w1 = load_le64(b + 8);    // msg_id/packet_offset word, ...
+    const uint64_t w3 = load_le64(b + 24);   // parity_idx, payload_len, flags, conn_id
+    const uint32_t word = static_cast<uint32_t>(w1);
+    info.transfer_id = be32_at(w0, 4);
+    info.generation_mask = UINT32_MAX;
+    info.msg_id = word & SDRPacketHeader::MAX_MSG_ID;
+    info.packet_offset = (word >> STANDARD_MSG_ID_BITS) & STANDARD_OFFSET_MASK;
+    info.conn_id = static_cast<uint32_t>(w3 >> 40);
+    info.payload_len = be16_at(w3, 2);
+    info.type = static_cast<uint8_t>(byte_at(w0, 2));
+    info.flags = static_cast<uint8_t>(byte_at(w3, 4));
+    info.header_size = sizeof(SDRPacketHeader);
+    read_crc(b, info);
+    return true;
+}
+
+inline bool decode_wide(const uint8_t* b, PacketInfo& info) {
+    const uint64_t w0 = load_le64(b);        // magic, type, flags, transfer_id
+    const uint64_t offset = __builtin_bswap64(load_le64(b + 8));
+    const uint64_t w2 = load_le64(b + 16);   // msg_id, chunk_seq
+    const uint64_t w3 = load_le64(b + 24);   // packets_per_chunk, payload_len, conn_id
+    info.transfer_id = be32_at(w0, 4);
+    info.generation_mask = UINT32_MAX;
+    info.msg_id = be32_at(w2, 0);
+    info.packet_offset = static_cast<uint32_t>(offset);
+    info.conn_id = be32_at(w3, 4) & SDRPacketHeader::CONN_ID_MASK;
+    info.payload_len = be16_at(w3, 2);
+    info.type = static_cast<uint8_t>(byte_at(w0, 2));
+    info.flags = static_cast<uint8_t>(byte_at(w0, 3));
+    info.header_size = sizeof(SDRWideHeader);
+    read_crc(b, info);
+    // Receive-side bitmaps index packets with 32 bits
+    return (offset >> 32) == 0;
+}
+
+inline bool decode_compact(const uint8_t* b, PacketInfo& info) {
+    const uint64_t w0 = load_le64(b);        // magic_version, flags, payload_len, msg_key
+    const uint32_t key = be32_at(w0, 4);
+    info.transfer_id = key >> SDRCompactHeader::MSG_ID_BITS;
+    info.generation_mask = SDRCompactHeader::GENERATION_MASK;
+    info.msg_id = key & SDRPacketHeader::MAX_MSG_ID;
+    info.packet_offset = load_be32(b + offsets::COMPACT_PACKET_OFFSET);
+    info.conn_id = 0;
+    info.payload_len = be16_at(w0, 2);
+    info.type = static_cast<uint8_t>(PacketType::DATA);
+    info.flags = static_cast<uint8_t>(byte_at(w0, 1));
+    info.header_size = sizeof(SDRCompactHeader);
+    info.crc32c = 0;
+    info.header_crc = 0;
+    return true;
+}
+
+} // namespace detail
+
+// Decode the header at the start of a datagram of len bytes; false if the magic
+// matches no layout, the datagram is shorter than its header or a wide offset is
+// past 32 bits
+inline bool decode(const uint8_t* bytes, size_t len, PacketInfo& info) {
+    if (len >= sizeof(SDRPacketHeader)) {
+        const uint16_t magic = static_cast<uint16_t>((bytes[0] << 8) | bytes[1]);
+        if (magic == SDRPacketHeader::MAGIC_VALUE) {
+            return detail::decode_standard(bytes, info);
+        }
+        if (magic == SDRWideHeader::MAGIC_VALUE) {
+            return detail::decode_wide(bytes, info);
+        }
+    }
+    return len >= sizeof(SDRCompactHeader) && bytes[0] == SDRCompactHeader::MAGIC_VERSION &&
+           detail::decode_compact(bytes, info);
+}
+
+// Write a whole header of the given layout (header_size(format) bytes).
+// Fields a layout has no room for are dropped; the compact key keeps the low
+// generation bits.
+inline void encode(HeaderFormat format, const HeaderFields& f, uint8_t* out) {
+    std::memset(out, 0, header_size(format));
+    if (format == HeaderFormat::COMPACT) {
+        out[0] = SDRCompactHeader::MAGIC_VERSION;
+        out[offsets::COMPACT_FLAGS] = f.flags;
+        detail::store_be16(out + offsets::COMPACT_PAYLOAD_LEN, f.payload_len);
+        detail::store_be32(out + offsets::COMPACT_MSG_KEY, SDRCompactHeader::make_key(f.transfer_id, f.msg_id));
+        detail::store_be32(out + offsets::COMPACT_PACKET_OFFSET, f.packet_offset);
+        return;
+    }
+    out[2] = f.type;
+    detail::store_be32(out + 4, f.transfer_id);
+    if (format == HeaderFormat::WIDE) {
+        detail::store_be16(out, SDRWideHeader::MAGIC_VALUE);
+        out[offsets::WIDE_FLAGS] = f.flags;
+        detail::store_be64(out + offsets::WIDE_PACKET_OFFSET, f.packet_offset);
+        detail::store_be32(out + offsets::WIDE_MSG_ID, f.msg_id);
+        detail::store_be32(out + offsets::WIDE_CHUNK_SEQ, f.chunk_seq);
+        detail::store_be16(out + offsets::WIDE_PACKETS_PER_CHUNK, f.packets_per_chunk);
+        detail::store_be16(out + offsets::WIDE_PAYLOAD_LEN, f.payload_len);
+        detail::store_be32(out + offsets::WIDE_CONN_ID, f.conn_id & SDRPacketHeader::CONN_ID_MASK);
+        return;
+    }
+    detail::store_be16(out, SDRPacketHeader::MAGIC_VALUE);
+    detail::store_le32(out + offsets::STANDARD_OFFSET_WORD,
+                       (f.msg_id & SDRPacketHeader::MAX_MSG_ID) |
+                       ((f.packet_offset & STANDARD_OFFSET_MASK) << STANDARD_MSG_ID_BITS));
+    detail::store_be32(out + offsets::STANDARD_CHUNK_SEQ, f.chunk_seq);
+    detail::store_be16(out + offsets::STANDARD_PACKETS_PER_CHUNK, f.packets_per_chunk);
+    detail::store_be16(out + offsets::STANDARD_PAYLOAD_LEN, f.payload_len);
+    out[offsets::STANDARD_FLAGS] = f.flags;
+    out[offsets::STANDARD_CONN_ID] = static_cast<uint8_t>(f.conn_id);
+    out[offsets::STANDARD_CONN_ID + 1] = static_cast<uint8_t>(f.conn_id >> 8);
+    out[offsets::STANDARD_CONN_ID + 2] = static_cast<uint8_t>(f.conn_id >> 16);
+}
+
+// Rewrite the per-packet fields of a header encoded by encode(); msg_id is the
+// one the header was encoded with (it shares a word with the standard offset)
+inline void patch(HeaderFormat format, uint8_t* out, uint32_t msg_id, uint32_t packet_offset,
+                  uint32_t chunk_seq, uint16_t payload_len) {
+    switch (format) {
+    case HeaderFormat::COMPACT:
+        detail::store_be16(out + offsets::COMPACT_PAYLOAD_LEN, payload_len);
+        detail::store_be32(out + offsets::COMPACT_PACKET_OFFSET, packet_offset);
+        break;
+    case HeaderFormat::WIDE:
+        detail::store_be64(out + offsets::WIDE_PACKET_OFFSET, packet_offset);
+        detail::store_be32(out + offsets::WIDE_CHUNK_SEQ, chunk_seq);
+        detail::store_be16(out + offsets::WIDE_PAYLOAD_LEN, payload_len);
+        break;
+    case HeaderFormat::STANDARD:
+        detail::store_le32(out + offsets::STANDARD_OFFSET_WORD,
+                           (msg_id & SDRPacketHeader::MAX_MSG_ID) |
+                           ((packet_offset & STANDARD_OFFSET_MASK) << STANDARD_MSG_ID_BITS));
+        detail::store_be32(out + offsets::STANDARD_CHUNK_SEQ, chunk_seq);
+        detail::store_be16(out + offsets::STANDARD_PAYLOAD_LEN, payload_len);
+        break;
+    }
+}
+
+// Stamp the CRC32C of a 32-byte header (FLAG_CRC32C set, all other fields final)
+// and its payload
+inline void stamp_crc(uint8_t* header, const uint8_t* payload, size_t payload_len) {
+    detail::store_be32(header + offsets::CRC,
+                       crc32c::extend(detail::header_crc(header), payload, payload_len));
+}
+
+// True if a decoded packet carries a CRC32C and its payload matches it
+inline bool verify_crc(const PacketInfo& info, const uint8_t* payload, size_t payload_len) {
+    return (info.flags & FLAG_CRC32C) && crc32c::extend(info.header_crc, payload, payload_len) == info.crc32c;
+}
+
+// Byte holding PacketFlags in a layout
+inline size_t flags_offset(HeaderFormat format) {
+    switch (format) {
+    case HeaderFormat::COMPACT: return offsets::COMPACT_FLAGS;
+    case HeaderFormat::WIDE: return offsets::WIDE_FLAGS;
+    case HeaderFormat::STANDARD: break;
+    }
+    return offsets::STANDARD_FLAGS;
+}
+
+} // namespace sdr::header_codec
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <algorithm>
+#include <thread>
+#include <time.h>
+
+namespace sdr {
+
+// Token-bucket rate pacer for the data path
+// Tracks a virtual send clock (GCRA form of a token bucket): each acquire()
+// advances it by bytes / rate and waits until the clock is no more than one
+// burst ahead of real time. Lock-free, so TX threads of one connection can
+// share a bucket. A rate of 0 disables pacing.
+class TokenBucket {
+public:
+    static constexpr uint32_t DEFAULT_BURST_BYTES = 64 * 1024;
+
+    TokenBucket() : rate_(0), burst_bytes_(DEFAULT_BURST_BYTES), burst_ns_(0), tat_ns_(0) {}
+
+    // rate in bytes/sec (0 = unpaced); burst in bytes (0 = default)
+    void set_rate(uint64_t bytes_per_sec, uint32_t burst_bytes);
+
+    uint64_t rate() const { return rate_.load(std::memory_order_relaxed); }
+    uint32_t burst_bytes() const { return burst_bytes_.load(std::memory_order_relaxed); }
+    bool enabled() const { return rate() != 0; }
+
+    // Block until bytes may be sent at the configured rate
+    void acquire(size_t bytes);
+
+    static int64_t now_ns();
+
+private:
+    // Below this the wait spins instead of sleeping, since timer slack would overshoot
+    static constexpr int64_t SPIN_THRESHOLD_NS = 50 * 1000;
+
+    std::atomic<uint64_t> rate_;
+    std::atomic<uint32_t> burst_bytes_;
+    std::atomic<int64_t> burst_ns_;
+    std::atomic<int64_t> tat_ns_;    // Theoretical time the bucket drains to empty
+
+    static void wait_until(int64_t deadline_ns);
+};
+
+// Implementation
+inline int64_t TokenBucket::now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+inline void TokenBucket::set_rate(uint64_t bytes_per_sec, uint32_t burst_bytes) {
+    if (burst_bytes == 0) burst_bytes = DEFAULT_BURST_BYTES;
+    rate_.store(bytes_per_sec, std::memory_order_relaxed);
+    burst_bytes_.store(burst_bytes, std::memory_order_relaxed);
+    burst_ns_.store(bytes_per_sec ? static_cast<int64_t>(burst_bytes * 1000000000ULL / bytes_per_sec) : 0,
+                    std::memory_order_relaxed);
+    tat_ns_.store(0, std::memory_order_relaxed);
+}
+
+inline void TokenBucket::acquire(size_t bytes) {
+    uint64_t rate = rate_.load(std::memory_order_relaxed);
+    if (rate == 0 || bytes == 0) {
+        return;
+    }
+
+    int64_t cost_ns = static_cast<int64_t>(static_cast<unsigned __int128>(bytes) * 1000000000ULL / rate);
+    int64_t burst_ns = burst_ns_.load(std::memory_order_relaxed);
+    int64_t now = now_ns();
+    int64_t tat = tat_ns_.load(std::memory_order_relaxed);
+    int64_t next;
+    do {
+        // An idle bucket refills up to one burst, never beyond
+        next = std::max(tat, now) + cost_ns;
+    } while (!tat_ns_.compare_exchange_weak(tat, next, std::memory_order_relaxed));
+
+    wait_until(next - burst_ns);
+}
+
+inline void TokenBucket::wait_until(int64_t deadline_ns) {
+    while (true) {
+        int64_t remaining = deadline_ns - now_ns();
+        if (remaining <= 0) {
+            return;
+        }
+        if (remaining > SPIN_THRESHOLD_NS) {
+            // Absolute sleep avoids drift from wakeup latency accumulating
+            int64_t wake_ns = deadline_ns - SPIN_THRESHOLD_NS;
+            struct timespec ts;
+            ts.tv_sec = static_cast<time_t>(wake_ns / 1000000000LL);
+            ts.tv_nsec = static_cast<long>(wake_ns % 1000000000LL);
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace sdr
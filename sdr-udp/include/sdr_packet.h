@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <cstring>
 #include <arpa/inet.h>
+#include <endian.h>
 
 namespace sdr {
 
@@ -15,8 +16,20 @@ enum class PacketType : uint8_t {
     CTS = 4         // Clear to Send (not used in UDP packets, only TCP)
 };
 
+// Header flag bits
+enum PacketFlags : uint8_t {
+    // Packet is one segment of a GSO train: header + payload spans exactly the
+    // train's segment size, except for the train's last segment which may be short.
+    // Receivers with UDP_GRO split coalesced datagrams on that segment size.
+    FLAG_GSO_SEGMENT = 0x01,
+    // Bytes 20-23 of a 32-byte header carry the packet's CRC32C (see
+    // header_codec::stamp_crc): over the header with those bytes left out, then
+    // the payload. Set when CTS grants PACKET_HEADER_CRC32C.
+    FLAG_CRC32C = 0x02
+};
+
 // Bitpacked UDP packet header
-// Total header size: 16 bytes (128 bits)
+// Total header size: 32 bytes (packed; see SDRCompactHeader for the 12-byte layout)
 // Layout:
 //   magic:      16 bits
 //   type:       8 bits
@@ -26,11 +39,12 @@ enum class PacketType : uint8_t {
 //   submsg_id:  16 bits (for EC group index, future use)
 //   chunk_seq:  32 bits (chunk sequence number)
 //   packets_per_chunk: 16 bits
-//   fec_k:      16 bits (for future EC use)
-//   fec_m:      16 bits (for future EC use)
+//   fec_k:      16 bits (for future EC use; with FLAG_CRC32C, fec_k and fec_m
+//   fec_m:      16 bits  hold the packet CRC32C)
 //   parity_idx: 16 bits (if type=PARITY, which parity chunk)
 //   payload_len: 16 bits (actual payload size, useful for last packet)
-//   flags:      8 bits (optional flags)
+//   flags:      8 bits (PacketFlags)
+//   conn_id:    24 bits (receiver connection id from CTS, 0 = unset; RXEngine demux key)
 struct __attribute__((packed)) SDRPacketHeader {
     uint16_t magic;              // Magic number: 0x5344 ("SD")
     uint8_t type;                // PacketType enum value
@@ -51,11 +65,14 @@ struct __attribute__((packed)) SDRPacketHeader {
     uint16_t fec_m;              // FEC parity chunks
     uint16_t parity_idx;         // Parity index (if type=PARITY)
     uint16_t payload_len;        // Actual payload length (can be < MTU for last packet)
-    uint8_t flags;               // Optional flags
-    uint8_t _reserved3[3];       // Padding to 16-byte boundary
+    uint8_t flags;               // PacketFlags bits
+    uint32_t conn_id : 24;       // Receiver connection id (low 24 bits of the CTS connection_id)
     
     // Helper methods
     static constexpr uint16_t MAGIC_VALUE = 0x5344; // "SD"
+    static constexpr uint32_t CONN_ID_MASK = 0xFFFFFF;
+    static constexpr uint32_t MAX_PACKETS = 1u << 18;   // packet_offset range
+    static constexpr uint32_t MAX_MSG_ID = (1u << 10) - 1;
     
     // Calculate chunk ID from packet offset
     uint32_t get_chunk_id() const {
@@ -75,8 +92,9 @@ struct __attribute__((packed)) SDRPacketHeader {
     }
     
     // Serialization (for network byte order conversion)
-    // Note: Bitfields (msg_id, packet_offset) require special handling
-    // For now, we assume host and network byte order are compatible for bitfields
+    // Note: Bitfields (msg_id, packet_offset, conn_id) keep the compiler's layout;
+    // the data path encodes and decodes through header_codec, which pins them to
+    // the bit positions x86 compilers produce
     void to_network_order() {
         magic = htons(magic);
         transfer_id = htonl(transfer_id);
@@ -87,7 +105,6 @@ struct __attribute__((packed)) SDRPacketHeader {
         fec_m = htons(fec_m);
         parity_idx = htons(parity_idx);
         payload_len = htons(payload_len);
-        // Note: msg_id and packet_offset are bitfields - handle carefully in production
     }
     
     void to_host_order() {
@@ -103,6 +120,125 @@ struct __attribute__((packed)) SDRPacketHeader {
     }
 };
 
+static_assert(sizeof(SDRPacketHeader) == 32, "SDRPacketHeader layout changed");
+
+// Data packet header layouts; the one a message uses is negotiated in OFFER/CTS
+enum class HeaderFormat : uint8_t {
+    STANDARD = 0,   // SDRPacketHeader
+    WIDE = 1,       // SDRWideHeader
+    COMPACT = 2     // SDRCompactHeader
+};
+
+// Wide-offset UDP packet header, for messages past SDRPacketHeader::MAX_PACKETS
+// Same 32 bytes as the standard header, so receive rings and GSO segment sizes do
+// not depend on the layout: the EC fields reserved for future use make room for
+// a 64-bit packet offset and a 32-bit msg_id. A distinct magic tells the layouts
+// apart. All fields are in network byte order on the wire.
+// Layout:
+//   magic:         16 bits (0x5357, "SW")
+//   type:          8 bits
+//   flags:         8 bits (PacketFlags)
+//   transfer_id:   32 bits
+//   packet_offset: 64 bits
+//   msg_id:        32 bits
+//   chunk_seq:     32 bits (with FLAG_CRC32C, the packet CRC32C instead;
+//                  receivers derive the chunk from the offset)
+//   packets_per_chunk: 16 bits
+//   payload_len:   16 bits
+//   conn_id:       32 bits (low 24 bits used, as in SDRPacketHeader)
+struct __attribute__((packed)) SDRWideHeader {
+    uint16_t magic;
+    uint8_t type;
+    uint8_t flags;
+    uint32_t transfer_id;
+    uint64_t packet_offset;
+    uint32_t msg_id;
+    uint32_t chunk_seq;
+    uint16_t packets_per_chunk;
+    uint16_t payload_len;
+    uint32_t conn_id;
+
+    static constexpr uint16_t MAGIC_VALUE = 0x5357; // "SW"
+
+    void to_network_order() {
+        magic = htons(magic);
+        transfer_id = htonl(transfer_id);
+        packet_offset = htobe64(packet_offset);
+        msg_id = htonl(msg_id);
+        chunk_seq = htonl(chunk_seq);
+        packets_per_chunk = htons(packets_per_chunk);
+        payload_len = htons(payload_len);
+        conn_id = htonl(conn_id);
+    }
+};
+
+static_assert(sizeof(SDRWideHeader) == sizeof(SDRPacketHeader), "Header layouts must share one size");
+
+// Compact UDP packet header: only what varies per packet, 12 bytes
+// Packets per chunk, the FEC fields and the receiver connection are per-message
+// constants the receiver already has from the handshake, so they are not sent.
+// With no conn_id it cannot be routed by the shared RXEngine, and receivers only
+// grant it to per-connection channel threads. The generation is cut to its low
+// GENERATION_BITS, enough to tell a slot's recent occupants apart.
+// All fields are in network byte order on the wire.
+// Layout:
+//   magic_version: 8 bits (0xC1: compact magic 0xC in the high nibble, version 1)
+//   flags:         8 bits (PacketFlags)
+//   payload_len:   16 bits
+//   msg_key:       32 bits (generation low 22 bits << 10 | msg_id)
+//   packet_offset: 32 bits
+struct __attribute__((packed)) SDRCompactHeader {
+    uint8_t magic_version;
+    uint8_t flags;
+    uint16_t payload_len;
+    uint32_t msg_key;
+    uint32_t packet_offset;
+
+    static constexpr uint8_t MAGIC_VERSION = 0xC1;
+    static constexpr uint32_t MSG_ID_BITS = 10;
+    static constexpr uint32_t GENERATION_BITS = 22;
+    static constexpr uint32_t GENERATION_MASK = (1u << GENERATION_BITS) - 1;
+
+    static uint32_t make_key(uint32_t generation, uint32_t msg_id) {
+        return ((generation & GENERATION_MASK) << MSG_ID_BITS) | (msg_id & SDRPacketHeader::MAX_MSG_ID);
+    }
+};
+
+static_assert(sizeof(SDRCompactHeader) == 12, "SDRCompactHeader layout changed");
+
+// Wire size of a header layout
+inline size_t header_size(HeaderFormat format) {
+    return format == HeaderFormat::COMPACT ? sizeof(SDRCompactHeader) : sizeof(SDRPacketHeader);
+}
+
+// Header size of the datagram starting with this byte (the first magic byte on
+// the wire), 0 if it starts no layout
+inline size_t header_size_of(uint8_t first_byte) {
+    if (first_byte == SDRCompactHeader::MAGIC_VERSION) {
+        return sizeof(SDRCompactHeader);
+    }
+    // Both 32-byte layouts start with 'S'
+    return first_byte == (SDRPacketHeader::MAGIC_VALUE >> 8) ? sizeof(SDRPacketHeader) : 0;
+}
+
+// Host-order fields of a received data packet, whichever layout it arrived in
+// (filled by header_codec::decode). Receive-side bitmaps index packets with 32
+// bits, so wide offsets past that are rejected at decode (2^32 packets is 4 TiB
+// even at a 1 KiB MTU).
+struct PacketInfo {
+    uint32_t transfer_id;        // Generation, masked by generation_mask
+    uint32_t generation_mask;    // Generation bits the header carries
+    uint32_t msg_id;
+    uint32_t packet_offset;
+    uint32_t conn_id;            // 0 for compact headers
+    uint16_t payload_len;
+    uint8_t type;
+    uint8_t flags;
+    uint8_t header_size;         // Bytes before the payload
+    uint32_t crc32c;             // FLAG_CRC32C: CRC32C the sender stamped
+    uint32_t header_crc;         // FLAG_CRC32C: CRC32C of the header without it, to extend over the payload
+};
+
 // Complete SDR packet structure (header + payload)
 struct SDRPacket {
     SDRPacketHeader header;
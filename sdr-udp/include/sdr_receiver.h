@@ -1,6 +1,7 @@
 #pragma once
 
 #include "sdr_packet.h"
+#include "sdr_header_codec.h"
 #include "sdr_connection.h"
 #include "sdr_backend.h"
 #include <cstdint>
@@ -9,12 +10,16 @@
 #include <memory>
 #include <mutex>
 #include <vector>
+#include <optional>
 #include <algorithm>
 #include <iostream>
 #include <cstring>
 #include <chrono>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <poll.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <cerrno>
@@ -25,53 +30,143 @@ namespace sdr {
 // Receives packets and updates backend packet bitmaps
 class UDPReceiver {
 public:
+    static constexpr uint32_t DEFAULT_RX_BATCH_SIZE = 64;
+    static constexpr uint32_t MAX_RX_BATCH_SIZE = 1024;
+    static constexpr size_t GRO_MAX_DATAGRAM = 65535;  // Largest coalesced datagram UDP_GRO hands up
+
     UDPReceiver(std::shared_ptr<ConnectionContext> connection);
     ~UDPReceiver();
     
-    bool start(uint16_t base_port, uint16_t num_channels);
+    // rx_batch_size: datagrams pulled per recvmmsg call (0 = default, 1 = one per call)
+    // direct_placement: receive payloads straight into the user buffer when the
+    // next packet offset on a channel can be predicted
+    // udp_gro: let the kernel coalesce packets (UDP_GRO) and split them here;
+    // falls back to plain datagrams when the socket option is unavailable
+    bool start(uint16_t base_port, uint16_t num_channels, uint32_t rx_batch_size = 0,
+               bool direct_placement = false, bool udp_gro = false);
     
     void stop();
     
     bool is_running() const { return is_running_.load(); }
     
+    // Direct-placement outcome counters (packets placed in-buffer vs. re-copied)
+    uint64_t placement_hits() const { return placement_hits_.load(std::memory_order_relaxed); }
+    uint64_t placement_misses() const { return placement_misses_.load(std::memory_order_relaxed); }
+    
+    // Datagram decoding and placement below are shared with RXEngine
+    
+    // One SDR packet located in the receive ring (or user buffer) during a batch
+    struct RxPacket {
+        PacketInfo header;
+        const uint8_t* payload;
+        size_t payload_len;
+    };
+    
+    // Writer reference on a message (MessageContext::begin_write), dropped when the
+    // holder moves to another message or goes out of scope. Holders stay epoch-pinned.
+    struct WriteRef {
+        MessageContext* ctx{nullptr};
+        WriteRef() = default;
+        WriteRef(const WriteRef&) = delete;
+        WriteRef& operator=(const WriteRef&) = delete;
+        ~WriteRef() { reset(); }
+        void reset(MessageContext* next = nullptr) {
+            if (ctx) ctx->end_write();
+            ctx = next;
+        }
+    };
+    
+    // Segment size reported by UDP_GRO for a coalesced datagram, or 0 if not coalesced
+    static size_t gro_segment_size(const struct msghdr& hdr);
+    
+    // Validate and decode a datagram header (either layout); returns false if the
+    // datagram should be dropped
+    static bool parse_datagram(const uint8_t* header_bytes, size_t len, PacketInfo& header,
+                               size_t& payload_len);
+    
+    // Returns true if the packet was accepted into the message; the caller holds a
+    // writer reference on msg_ctx
+    static bool process_packet(MessageContext* msg_ctx, const PacketInfo& header,
+                               const uint8_t* payload, size_t payload_len);
+    
+    static void write_packet_to_buffer(MessageContext* msg_ctx, uint32_t packet_offset,
+                                       const uint8_t* payload, size_t payload_len);
+    
 private:
     std::shared_ptr<ConnectionContext> connection_;
     struct Worker {
         std::thread thread;
         int udp_socket_fd{-1};
         uint16_t udp_port{0};
+        bool gro{false};             // UDP_GRO accepted on this socket
     };
     std::vector<Worker> workers_;
     std::atomic<bool> should_stop_;
     std::atomic<bool> is_running_;
     uint16_t base_port_;
     uint16_t num_channels_;
+    uint32_t rx_batch_size_;
+    size_t max_packet_size_;     // Size of each receive ring slot
+    bool direct_placement_;
+    bool udp_gro_;
+    std::atomic<uint64_t> placement_hits_;
+    std::atomic<uint64_t> placement_misses_;
+    
+    static constexpr uint32_t NO_PREDICTION = UINT32_MAX;
+    
+    // Message and next packet offset a worker expects on its channel
+    struct PlacementTarget {
+        bool valid{false};
+        uint32_t msg_id{0};
+        uint32_t generation{0};
+        uint32_t next_offset{0};
+    };
     
     void receiver_thread_func(size_t worker_idx);
     
-    void process_packet(const SDRPacketHeader& header, const uint8_t* payload, size_t payload_len);
+    // Point payload iovecs of the batch at predicted user-buffer slices; returns slots planned.
+    // While any are planned, writer holds the message so it cannot close under recvmmsg.
+    uint32_t plan_placement(PlacementTarget& target, struct iovec* iovs,
+                            uint32_t* predicted, uint32_t batch, WriteRef& writer);
     
-    void write_packet_to_buffer(MessageContext* msg_ctx, uint32_t packet_offset,
-                                const uint8_t* payload, size_t payload_len);
 };
 
 // Implementation
 inline UDPReceiver::UDPReceiver(std::shared_ptr<ConnectionContext> connection)
     : connection_(connection), should_stop_(false), is_running_(false),
-      base_port_(0), num_channels_(1) {
+      base_port_(0), num_channels_(1), rx_batch_size_(DEFAULT_RX_BATCH_SIZE),
+      max_packet_size_(sizeof(SDRPacketHeader) + SDRPacket::MAX_PAYLOAD_SIZE),
+      direct_placement_(false), udp_gro_(false), placement_hits_(0), placement_misses_(0) {
 }
 
 inline UDPReceiver::~UDPReceiver() {
     stop();
 }
 
-inline bool UDPReceiver::start(uint16_t base_port, uint16_t num_channels) {
+inline bool UDPReceiver::start(uint16_t base_port, uint16_t num_channels, uint32_t rx_batch_size,
+                               bool direct_placement, bool udp_gro) {
     if (is_running_.load()) {
         return false; // Already running
     }
     
     base_port_ = base_port;
     num_channels_ = std::max<uint16_t>(1, num_channels);
+    rx_batch_size_ = std::min(rx_batch_size ? rx_batch_size : DEFAULT_RX_BATCH_SIZE, MAX_RX_BATCH_SIZE);
+    direct_placement_ = direct_placement;
+#ifdef UDP_GRO
+    udp_gro_ = udp_gro;
+#else
+    udp_gro_ = false;
+    if (udp_gro) {
+        std::cerr << "[UDP Receiver] Warning: UDP_GRO not supported by this build, receiving plain datagrams" << std::endl;
+    }
+#endif
+    // Size ring slots to the negotiated MTU so a batch stays cache/TLB friendly;
+    // with GRO a slot must hold a whole coalesced datagram
+    uint32_t mtu_bytes = connection_->get_params().mtu_bytes;
+    size_t payload_capacity = (mtu_bytes && mtu_bytes < SDRPacket::MAX_PAYLOAD_SIZE) ? mtu_bytes
+                                                                                    : SDRPacket::MAX_PAYLOAD_SIZE;
+    max_packet_size_ = udp_gro_ ? GRO_MAX_DATAGRAM : sizeof(SDRPacketHeader) + payload_capacity;
     workers_.clear();
     workers_.resize(num_channels_);
     should_stop_.store(false);
@@ -98,6 +193,18 @@ inline bool UDPReceiver::start(uint16_t base_port, uint16_t num_channels) {
             std::cerr << "[UDP Receiver] Warning: Failed to set SO_RCVBUF: " << strerror(errno) << std::endl;
         }
         
+#ifdef UDP_GRO
+        if (udp_gro_) {
+            int gro = 1;
+            if (setsockopt(udp_socket_fd_, SOL_UDP, UDP_GRO, &gro, sizeof(gro)) == 0) {
+                workers_[idx].gro = true;
+            } else {
+                std::cerr << "[UDP Receiver] Warning: UDP_GRO unavailable on port " << port
+                          << " (" << strerror(errno) << "), receiving plain datagrams" << std::endl;
+            }
+        }
+#endif
+        
         struct sockaddr_in server_addr;
         std::memset(&server_addr, 0, sizeof(server_addr));
         server_addr.sin_family = AF_INET;
@@ -126,7 +233,9 @@ inline bool UDPReceiver::start(uint16_t base_port, uint16_t num_channels) {
 
     is_running_.store(true);
     std::cout << "[UDP Receiver] Started " << workers_.size() << " channel(s) at base port "
-              << base_port_ << std::endl;
+              << base_port_ << ", batch " << rx_batch_size_
+              << (direct_placement_ ? ", direct placement" : "")
+              << (udp_gro_ ? ", GRO" : "") << std::endl;
     return true;
 }
 
@@ -147,114 +256,331 @@ inline void UDPReceiver::stop() {
 }
 
 inline void UDPReceiver::receiver_thread_func(size_t worker_idx) {
-    const size_t max_packet_size = sizeof(SDRPacketHeader) + SDRPacket::MAX_PAYLOAD_SIZE;
-    uint8_t recv_buffer[max_packet_size];
-
     if (worker_idx >= workers_.size()) {
         return;
     }
     int udp_socket_fd_ = workers_[worker_idx].udp_socket_fd;
+    const bool gro = workers_[worker_idx].gro;
+    // A coalesced datagram carries several headers, so it cannot be scattered by prediction
+    const bool direct_placement = direct_placement_ && !gro;
+
+    // Set socket timeout for polling once; recvmmsg applies it to the first datagram
+    struct timeval tv;
+    tv.tv_sec = 0;
+    tv.tv_usec = 100000; // 100ms timeout
+    setsockopt(udp_socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+    // Preallocated ring of receive slots, one per datagram in a batch. Each
+    // datagram is scattered into the slot's header area plus a payload area that
+    // is either the slot's own scratch or a predicted slice of the user buffer.
+    // The header area is sized for the largest layout, and for the predicted
+    // message's own layout while a slot is planned.
+    const uint32_t batch = rx_batch_size_;
+    const size_t header_size = sizeof(SDRPacketHeader);
+    std::vector<uint8_t> ring(max_packet_size_ * batch);
+    std::vector<struct mmsghdr> msgs(batch);
+    std::vector<struct iovec> iovs(static_cast<size_t>(batch) * 2);
+    std::vector<uint32_t> predicted(batch, NO_PREDICTION);
+    std::vector<RxPacket> packets;
+    packets.reserve(batch);
+    // Control buffers for the UDP_GRO segment size cmsg
+    const size_t control_space = CMSG_SPACE(sizeof(int));
+    std::vector<uint8_t> control(gro ? control_space * batch : 0);
+
+    auto reset_slot = [&](uint32_t i) {
+        uint8_t* slot = ring.data() + i * max_packet_size_;
+        iovs[2 * i].iov_base = slot;
+        iovs[2 * i].iov_len = header_size;
+        iovs[2 * i + 1].iov_base = slot + header_size;
+        iovs[2 * i + 1].iov_len = max_packet_size_ - header_size;
+        predicted[i] = NO_PREDICTION;
+    };
+    for (uint32_t i = 0; i < batch; ++i) {
+        reset_slot(i);
+        std::memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iovs[2 * i];
+        msgs[i].msg_hdr.msg_iovlen = 2;
+    }
+
+    PlacementTarget target;
 
-    struct sockaddr_in client_addr;
-    socklen_t client_len = sizeof(client_addr);
-    
     std::cout << "[UDP Receiver] Thread started on port " << workers_[worker_idx].udp_port
               << ", waiting for packets..." << std::endl;
-    
+
     while (!should_stop_.load(std::memory_order_acquire)) {
-        // Set socket timeout for polling
-        struct timeval tv;
-        tv.tv_sec = 0;
-        tv.tv_usec = 100000; // 100ms timeout
-        setsockopt(udp_socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
-        
-        ssize_t n = recvfrom(udp_socket_fd_, recv_buffer, max_packet_size, 0,
-                            (struct sockaddr*)&client_addr, &client_len);
+        int flags = MSG_WAITFORONE;
+        uint32_t planned = 0;
+        // Pinned from planning until the batch is processed, never across a blocking wait.
+        // Declared before the writer references so those are dropped first.
+        std::optional<EpochDomain::Guard> pinned;
+        WriteRef placement_writer;
+        if (direct_placement && target.valid) {
+            // Wait in poll() instead of recvmmsg so payload iovecs never point into
+            // a user buffer across a long block; plan once data is queued
+            struct pollfd pfd;
+            pfd.fd = udp_socket_fd_;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            int ready = poll(&pfd, 1, 100);
+            if (ready <= 0) {
+                if (ready < 0 && errno != EINTR) {
+                    std::cerr << "[UDP Receiver] Poll failed: " << strerror(errno) << std::endl;
+                    break;
+                }
+                continue;
+            }
+            pinned.emplace(EpochDomain::instance());
+            planned = plan_placement(target, iovs.data(), predicted.data(), batch, placement_writer);
+            flags = MSG_DONTWAIT;
+        }
+
+        if (gro) {
+            for (uint32_t i = 0; i < batch; ++i) {
+                msgs[i].msg_hdr.msg_control = control.data() + i * control_space;
+                msgs[i].msg_hdr.msg_controllen = control_space;
+            }
+        }
         
+        // Block for the first datagram, then take whatever else is already queued
+        int n = recvmmsg(udp_socket_fd_, msgs.data(), batch, flags, nullptr);
+
         if (n < 0) {
+            for (uint32_t i = 0; planned > 0 && i < batch; ++i) {
+                if (predicted[i] != NO_PREDICTION) reset_slot(i);
+            }
             if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
                 // Timeout or interrupted, continue
                 continue;
             }
-            std::cerr << "[UDP Receiver] Recvfrom failed: " << strerror(errno) << std::endl;
+            std::cerr << "[UDP Receiver] Recvmmsg failed: " << strerror(errno) << std::endl;
             break;
         }
-        
-        if (n < static_cast<ssize_t>(sizeof(SDRPacketHeader))) {
-            std::cerr << "[UDP Receiver] Packet too small: " << n << " bytes" << std::endl;
-            continue;
+
+        // Pass 1: decode headers. Payloads that landed in a mispredicted slice are
+        // moved to slot scratch before any copy in pass 2 can overwrite them.
+        packets.clear();
+        for (int i = 0; i < n; ++i) {
+            bool truncated = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+            msgs[i].msg_hdr.msg_flags = 0;
+            if (truncated) {
+                if (predicted[i] == NO_PREDICTION) {
+                    std::cerr << "[UDP Receiver] Datagram larger than " << max_packet_size_
+                              << " bytes truncated, dropping" << std::endl;
+                } else {
+                    placement_misses_.fetch_add(1, std::memory_order_relaxed);
+                }
+                continue;
+            }
+
+            const uint8_t* slot = static_cast<const uint8_t*>(iovs[2 * i].iov_base);
+            size_t segment_size = gro ? gro_segment_size(msgs[i].msg_hdr) : 0;
+            if (segment_size > 0 && segment_size < msgs[i].msg_len) {
+                // Coalesced datagram: every segment carries its own header; the
+                // header and payload iovecs of a scratch slot are contiguous
+                for (size_t pos = 0; pos < msgs[i].msg_len; pos += segment_size) {
+                    RxPacket pkt;
+                    size_t segment_len = std::min(segment_size, static_cast<size_t>(msgs[i].msg_len) - pos);
+                    if (!parse_datagram(slot + pos, segment_len, pkt.header, pkt.payload_len)) {
+                        continue;
+                    }
+                    pkt.payload = slot + pos + pkt.header.header_size;
+                    packets.push_back(pkt);
+                }
+                continue;
+            }
+
+            RxPacket pkt;
+            if (predicted[i] != NO_PREDICTION) {
+                // The kernel split the datagram after the predicted layout's header
+                const size_t split = iovs[2 * i].iov_len;
+                uint8_t* landed = static_cast<uint8_t*>(iovs[2 * i + 1].iov_base);
+                bool hit = msgs[i].msg_len >= split && header_size_of(slot[0]) == split &&
+                           parse_datagram(slot, msgs[i].msg_len, pkt.header, pkt.payload_len) &&
+                           pkt.header.msg_id == target.msg_id &&
+                           pkt.header.transfer_id == (target.generation & pkt.header.generation_mask) &&
+                           pkt.header.packet_offset == predicted[i] &&
+                           pkt.payload_len == iovs[2 * i + 1].iov_len;
+                if (hit) {
+                    placement_hits_.fetch_add(1, std::memory_order_relaxed);
+                    pkt.payload = landed;
+                    packets.push_back(pkt);
+                    continue;
+                }
+                // Gather the datagram back into the slot, then decode it as unplanned
+                if (msgs[i].msg_len > split) {
+                    std::memcpy(ring.data() + i * max_packet_size_ + split, landed, msgs[i].msg_len - split);
+                }
+                placement_misses_.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (!parse_datagram(slot, msgs[i].msg_len, pkt.header, pkt.payload_len)) {
+                continue;
+            }
+            pkt.payload = slot + pkt.header.header_size;
+            packets.push_back(pkt);
         }
-        
-        // Parse header
-        SDRPacketHeader header;
-        std::memcpy(&header, recv_buffer, sizeof(SDRPacketHeader));
-        header.to_host_order();
-        
-        // Validate header
-        if (!header.is_valid()) {
-            std::cerr << "[UDP Receiver] Invalid packet header (magic mismatch)" << std::endl;
+
+        // Pass 2: consecutive packets of one message generation share a single
+        // message-table lookup and writer reference
+        if (!pinned) {
+            pinned.emplace(EpochDomain::instance());
+        }
+        WriteRef writer;
+        uint32_t cached_msg_id = UINT32_MAX;
+        uint32_t cached_generation = 0;
+
+        for (const RxPacket& pkt : packets) {
+            const PacketInfo& header = pkt.header;
+            if (header.msg_id != cached_msg_id || header.transfer_id != cached_generation) {
+                cached_msg_id = header.msg_id;
+                cached_generation = header.transfer_id;
+                MessageContext* msg_ctx = connection_->get_message(cached_msg_id);
+                writer.reset(msg_ctx && msg_ctx->begin_write(cached_generation, header.generation_mask) ? msg_ctx
+                                                                                                      : nullptr);
+            }
+
+            if (process_packet(writer.ctx, header, pkt.payload, pkt.payload_len)) {
+                // A channel only carries offsets congruent to its index
+                target.valid = true;
+                target.msg_id = header.msg_id;
+                target.generation = writer.ctx->generation();
+                target.next_offset = header.packet_offset + num_channels_;
+            }
+        }
+
+        for (uint32_t i = 0; planned > 0 && i < batch; ++i) {
+            if (predicted[i] != NO_PREDICTION) reset_slot(i);
+        }
+    }
+
+}
+
+inline uint32_t UDPReceiver::plan_placement(PlacementTarget& target, struct iovec* iovs,
+                                            uint32_t* predicted, uint32_t batch, WriteRef& writer) {
+    MessageContext* msg_ctx = connection_->get_message(target.msg_id);
+    if (!msg_ctx || !msg_ctx->begin_write(target.generation)) {
+        target.valid = false;
+        return 0;
+    }
+    writer.reset(msg_ctx);
+    if (!msg_ctx->buffer || !msg_ctx->backend_bitmap) {
+        writer.reset();
+        target.valid = false;
+        return 0;
+    }
+
+    const size_t mtu_bytes = msg_ctx->connection_params.mtu_bytes;
+    // The message's header layout decides where the kernel splits header from payload
+    const size_t split = header_size(negotiated_header_format(msg_ctx->connection_params));
+    if (mtu_bytes == 0 || mtu_bytes > max_packet_size_ - sizeof(SDRPacketHeader)) {
+        writer.reset();
+        target.valid = false;
+        return 0;
+    }
+
+    uint32_t planned = 0;
+    for (uint32_t i = 0; i < batch; ++i) {
+        uint64_t packet_offset = target.next_offset + static_cast<uint64_t>(i) * num_channels_;
+        if (packet_offset >= msg_ctx->total_packets) {
+            break;
+        }
+        size_t buffer_offset = static_cast<size_t>(packet_offset) * mtu_bytes;
+        if (buffer_offset + mtu_bytes > msg_ctx->buffer_size) {
+            break; // Short tail packet goes through the copy path
+        }
+        // Only this channel's worker writes these offsets, so an unreceived slice is free to scatter into
+        if (msg_ctx->backend_bitmap->is_packet_received(static_cast<uint32_t>(packet_offset))) {
             continue;
         }
-        
-        // Get payload
-        const uint8_t* payload = recv_buffer + sizeof(SDRPacketHeader);
-        size_t actual_payload_len = n - sizeof(SDRPacketHeader);
-        size_t expected_payload_len = header.payload_len;
-        
-        // Use the smaller of actual received length or expected length
-        // But ensure we have at least some data
-        size_t payload_len = std::min(actual_payload_len, static_cast<size_t>(expected_payload_len));
-        
-        // Debug: log if there's a mismatch
-        if (actual_payload_len != expected_payload_len) {
-            std::cout << "[UDP Receiver] Packet " << header.packet_offset 
-                      << ": received " << actual_payload_len 
-                      << " bytes, expected " << expected_payload_len << std::endl;
+        iovs[2 * i].iov_len = split;
+        iovs[2 * i + 1].iov_base = static_cast<uint8_t*>(msg_ctx->buffer) + buffer_offset;
+        iovs[2 * i + 1].iov_len = mtu_bytes;
+        predicted[i] = static_cast<uint32_t>(packet_offset);
+        planned++;
+    }
+    if (planned == 0) {
+        writer.reset();
+    }
+    return planned;
+}
+
+inline size_t UDPReceiver::gro_segment_size(const struct msghdr& hdr) {
+#ifdef UDP_GRO
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&hdr), cmsg)) {
+        if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+            int segment_size = 0;
+            std::memcpy(&segment_size, CMSG_DATA(cmsg), sizeof(segment_size));
+            return segment_size > 0 ? static_cast<size_t>(segment_size) : 0;
         }
-        
-        // Process packet
-        process_packet(header, payload, payload_len);
     }
-    
+#else
+    (void)hdr;
+#endif
+    return 0;
+}
+
+inline bool UDPReceiver::parse_datagram(const uint8_t* header_bytes, size_t len, PacketInfo& header,
+                                        size_t& payload_len) {
+    // Parse and validate header
+    if (!header_codec::decode(header_bytes, len, header)) {
+        std::cerr << "[UDP Receiver] Invalid packet header (" << len
+                  << " bytes; magic mismatch, short datagram or offset out of range)" << std::endl;
+        return false;
+    }
+
+    size_t actual_payload_len = len - header.header_size;
+    size_t expected_payload_len = header.payload_len;
+
+    // Use the smaller of actual received length or expected length
+    // But ensure we have at least some data
+    payload_len = std::min(actual_payload_len, expected_payload_len);
+
+    // Debug: log if there's a mismatch
+    if (actual_payload_len != expected_payload_len) {
+        std::cout << "[UDP Receiver] Packet " << header.packet_offset
+                  << ": received " << actual_payload_len
+                  << " bytes, expected " << expected_payload_len << std::endl;
+    }
+    return true;
 }
 
-inline void UDPReceiver::process_packet(const SDRPacketHeader& header, 
+inline bool UDPReceiver::process_packet(MessageContext* msg_ctx, const PacketInfo& header,
                                        const uint8_t* payload, size_t payload_len) {
-    // Get message context
-    MessageContext* msg_ctx = connection_->get_message(header.msg_id);
-    
     if (!msg_ctx) {
         // Message doesn't exist (could be late packet or invalid msg_id)
-        return;
-    }
-    
-    // Check generation (basic late packet protection)
-    if (msg_ctx->generation != header.transfer_id) {
-        // Different generation, ignore
-        return;
+        return false;
     }
     
-    // Check state
-    if (msg_ctx->state == MessageState::DEAD || 
-        msg_ctx->state == MessageState::COMPLETED || 
-        msg_ctx->state == MessageState::NULL_STATE) {
-        // Message already completed, ignore late packet
-        return;
+    // Generation and state in one load: late packets of an older generation, or for
+    // a message that has since been closed, are ignored
+    if (!msg_ctx->accepts(header.transfer_id, header.generation_mask)) {
+        return false;
     }
     
     // Skip duplicate packet writes to avoid extra memcpy
     if (msg_ctx->backend_bitmap && msg_ctx->backend_bitmap->is_packet_received(header.packet_offset)) {
-        return;
+        return false;
+    }
+
+    // A packet failing its CRC32C (or missing one the CTS required) is dropped like
+    // a lost one; placed payloads sit in a slice no packet has filled yet
+    if ((msg_ctx->connection_params.packet_headers & PACKET_HEADER_CRC32C) &&
+        !header_codec::verify_crc(header, payload, payload_len)) {
+        msg_ctx->packets_corrupt.fetch_add(1, std::memory_order_relaxed);
+        return false;
     }
 
     // Write packet to buffer
     write_packet_to_buffer(msg_ctx, header.packet_offset, payload, payload_len);
     
-    // Update backend packet bitmap
+    // Update backend packet bitmap; the packet that completes a chunk publishes it
     if (msg_ctx->backend_bitmap) {
-        msg_ctx->backend_bitmap->set_packet_received(header.packet_offset);
-        // Removed verbose logging - progress is shown via chunk bitmap display
+        bool chunk_completed = false;
+        msg_ctx->backend_bitmap->set_packet_received(header.packet_offset, &chunk_completed);
+        if (chunk_completed && msg_ctx->frontend_bitmap) {
+            msg_ctx->frontend_bitmap->mark_chunk_complete(header.packet_offset / msg_ctx->packets_per_chunk);
+        }
     }
+    return true;
 }
 
 inline void UDPReceiver::write_packet_to_buffer(MessageContext* msg_ctx, 
@@ -294,8 +620,11 @@ inline void UDPReceiver::write_packet_to_buffer(MessageContext* msg_ctx,
         }
     }
     
-    // Write payload to buffer
-    std::memcpy(static_cast<uint8_t*>(msg_ctx->buffer) + buffer_offset, payload, payload_len);
+    // Write payload to buffer (already in place when the kernel scattered it there)
+    uint8_t* dest = static_cast<uint8_t*>(msg_ctx->buffer) + buffer_offset;
+    if (dest != payload) {
+        std::memcpy(dest, payload, payload_len);
+    }
     
     // Removed verbose logging - progress is shown via chunk bitmap display
 }
@@ -0,0 +1,467 @@
+#pragma once
+
+#include "sdr_packet.h"
+#include "sdr_connection.h"
+#include "sdr_receiver.h"
+#include "sdr_epoch.h"
+#include "tcp_control.h"
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace sdr {
+
+// Process-wide receive engine
+// One fixed pool of receive threads (one per core by default) serves every
+// connection registered with it, instead of a UDPReceiver with num_channels
+// sockets and threads per connection. Each thread owns one SO_REUSEPORT socket
+// per port in [base_port, base_port + num_ports), so the kernel spreads sender
+// flows across threads. Packets are demultiplexed by the conn_id in their header
+// through a lock-free connection table; entries are retired through the
+// EpochDomain, so a thread pinned for a batch never sees a freed connection.
+// Packets of one connection can arrive on any thread, so payloads always go
+// through the copy path (no direct placement).
+class RXEngine {
+public:
+    // Table slots, indexed by conn_id % MAX_CONNECTIONS. Ids are 24-bit and handed
+    // out in sequence, so after 65536 more connections a new id can land on the slot
+    // of one still open; register_connection then moves the new connection to a
+    // free slot's id. What remains is a cap of MAX_CONNECTIONS connections
+    // registered with the engine at once.
+    static constexpr size_t MAX_CONNECTIONS = 65536;
+
+    // The shared engine: created on first use, stopped when the last holder releases it
+    static std::shared_ptr<RXEngine> acquire();
+
+    RXEngine();
+    ~RXEngine();
+
+    RXEngine(const RXEngine&) = delete;
+    RXEngine& operator=(const RXEngine&) = delete;
+
+    // Bind num_ports ports on num_threads threads (0 = one per core). Ring slots hold
+    // max_payload bytes after the header (0 = SDRPacket::MAX_PAYLOAD_SIZE). Calling
+    // again while running succeeds if base_port matches; callers then fit their
+    // channel count and MTU to num_ports() and max_payload().
+    bool start(uint16_t base_port, uint16_t num_ports, uint32_t num_threads = 0,
+               uint32_t rx_batch_size = 0, size_t max_payload = 0, bool udp_gro = false);
+    void stop();
+    bool is_running() const { return is_running_.load(); }
+
+    uint16_t base_port() const { return base_port_; }
+    uint16_t num_ports() const { return num_ports_; }
+    size_t max_payload() const { return max_payload_; }
+    size_t num_threads() const { return workers_.size(); }
+
+    // Route packets carrying connection->get_connection_id() to this connection.
+    // If another live connection holds that id's table slot, the connection is given
+    // a fresh id (re-initializing its ConnectionContext) whose slot is free, so
+    // register before the id is sent to the peer in CTS. Fails if the id is zero or
+    // every slot is held.
+    bool register_connection(std::shared_ptr<ConnectionContext> connection);
+    void unregister_connection(uint32_t conn_id);
+
+    // Packets accepted into a message, and packets whose conn_id is not registered
+    uint64_t packets_received() const { return packets_received_.load(std::memory_order_relaxed); }
+    uint64_t packets_unrouted() const { return packets_unrouted_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        uint32_t conn_id;
+        std::shared_ptr<ConnectionContext> connection;
+    };
+
+    struct Worker {
+        std::thread thread;
+        std::vector<int> socket_fds;  // One per port
+        bool gro{false};              // UDP_GRO accepted on every socket
+    };
+
+    std::array<std::atomic<Entry*>, MAX_CONNECTIONS> table_;
+    std::mutex table_mutex_;              // Serializes table writers
+    std::mutex start_mutex_;              // Serializes start/stop
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> should_stop_;
+    std::atomic<bool> is_running_;
+    uint16_t base_port_;
+    uint16_t num_ports_;
+    uint32_t rx_batch_size_;
+    size_t max_payload_;
+    size_t max_packet_size_;              // Size of each receive ring slot
+    std::atomic<uint64_t> packets_received_;
+    std::atomic<uint64_t> packets_unrouted_;
+
+    // Registered connection for conn_id, or null; valid while the caller is pinned
+    ConnectionContext* lookup(uint32_t conn_id) const;
+
+    int open_socket(uint16_t port, bool& gro) const;
+    void worker_func(size_t worker_idx);
+    void receive_batch(int fd, bool gro, std::vector<uint8_t>& ring, std::vector<struct mmsghdr>& msgs,
+                       std::vector<uint8_t>& control, std::vector<UDPReceiver::RxPacket>& packets);
+};
+
+// Implementation
+inline std::shared_ptr<RXEngine> RXEngine::acquire() {
+    static std::mutex mutex;
+    static std::weak_ptr<RXEngine> shared;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<RXEngine> engine = shared.lock();
+    if (!engine) {
+        engine = std::make_shared<RXEngine>();
+        shared = engine;
+    }
+    return engine;
+}
+
+inline RXEngine::RXEngine()
+    : should_stop_(false), is_running_(false), base_port_(0), num_ports_(0),
+      rx_batch_size_(UDPReceiver::DEFAULT_RX_BATCH_SIZE), max_payload_(0), max_packet_size_(0),
+      packets_received_(0), packets_unrouted_(0) {
+    for (auto& slot : table_) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+    EpochDomain::instance(); // Constructed first so it outlives this engine
+}
+
+inline RXEngine::~RXEngine() {
+    stop();
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    for (auto& slot : table_) {
+        Entry* entry = slot.exchange(nullptr, std::memory_order_relaxed);
+        delete entry; // Workers are joined; nothing can hold it
+    }
+}
+
+inline bool RXEngine::start(uint16_t base_port, uint16_t num_ports, uint32_t num_threads,
+                            uint32_t rx_batch_size, size_t max_payload, bool udp_gro) {
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    if (is_running_.load()) {
+        if (base_port != base_port_) {
+            std::cerr << "[RX Engine] Already running on base port " << base_port_
+                      << ", cannot serve port " << base_port << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    base_port_ = base_port;
+    num_ports_ = std::max<uint16_t>(1, num_ports);
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    rx_batch_size_ = std::min(rx_batch_size ? rx_batch_size : UDPReceiver::DEFAULT_RX_BATCH_SIZE,
+                              UDPReceiver::MAX_RX_BATCH_SIZE);
+    max_payload_ = (max_payload && max_payload < SDRPacket::MAX_PAYLOAD_SIZE) ? max_payload
+                                                                              : SDRPacket::MAX_PAYLOAD_SIZE;
+#ifdef UDP_GRO
+    bool gro_requested = udp_gro;
+#else
+    bool gro_requested = false;
+    if (udp_gro) {
+        std::cerr << "[RX Engine] Warning: UDP_GRO not supported by this build, receiving plain datagrams" << std::endl;
+    }
+#endif
+    max_packet_size_ = gro_requested ? UDPReceiver::GRO_MAX_DATAGRAM : sizeof(SDRPacketHeader) + max_payload_;
+    should_stop_.store(false);
+
+    // Every thread joins each port's SO_REUSEPORT group before any thread runs
+    for (uint32_t t = 0; t < num_threads; ++t) {
+        auto worker = std::make_unique<Worker>();
+        worker->gro = gro_requested;
+        for (uint16_t p = 0; p < num_ports_; ++p) {
+            bool gro = gro_requested;
+            int fd = open_socket(static_cast<uint16_t>(base_port_ + p), gro);
+            if (fd < 0) {
+                for (int open_fd : worker->socket_fds) {
+                    close(open_fd);
+                }
+                for (auto& w : workers_) {
+                    for (int open_fd : w->socket_fds) {
+                        close(open_fd);
+                    }
+                }
+                workers_.clear();
+                return false;
+            }
+            worker->gro = worker->gro && gro;
+            worker->socket_fds.push_back(fd);
+        }
+        workers_.push_back(std::move(worker));
+    }
+
+    for (size_t t = 0; t < workers_.size(); ++t) {
+        workers_[t]->thread = std::thread(&RXEngine::worker_func, this, t);
+    }
+
+    is_running_.store(true);
+    std::cout << "[RX Engine] Started " << workers_.size() << " thread(s) on ports " << base_port_
+              << "-" << (base_port_ + num_ports_ - 1) << ", batch " << rx_batch_size_
+              << (gro_requested ? ", GRO" : "") << std::endl;
+    return true;
+}
+
+inline void RXEngine::stop() {
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    should_stop_.store(true);
+    for (auto& w : workers_) {
+        if (w->thread.joinable()) {
+            w->thread.join();
+        }
+        for (int fd : w->socket_fds) {
+            close(fd);
+        }
+    }
+    workers_.clear();
+    is_running_.store(false);
+}
+
+inline int RXEngine::open_socket(uint16_t port, bool& gro) const {
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        std::cerr << "[RX Engine] Failed to create socket: " << strerror(errno) << std::endl;
+        return -1;
+    }
+
+    int opt = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        std::cerr << "[RX Engine] SO_REUSEPORT failed: " << strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+
+    int recv_buf_size = 64 * 1024 * 1024; // 64 MB
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &recv_buf_size, sizeof(recv_buf_size)) < 0) {
+        std::cerr << "[RX Engine] Warning: Failed to set SO_RCVBUF: " << strerror(errno) << std::endl;
+    }
+
+#ifdef UDP_GRO
+    if (gro) {
+        int enable = 1;
+        if (setsockopt(fd, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) < 0) {
+            std::cerr << "[RX Engine] Warning: UDP_GRO unavailable on port " << port
+                      << " (" << strerror(errno) << "), receiving plain datagrams" << std::endl;
+            gro = false;
+        }
+    }
+#else
+    gro = false;
+#endif
+
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "[RX Engine] Bind failed on port " << port << ": " << strerror(errno) << std::endl;
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+inline bool RXEngine::register_connection(std::shared_ptr<ConnectionContext> connection) {
+    if (!connection) {
+        return false;
+    }
+    uint32_t conn_id = connection->get_connection_id() & SDRPacketHeader::CONN_ID_MASK;
+    if (conn_id == 0) {
+        std::cerr << "[RX Engine] Cannot register connection without an id" << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    for (size_t attempt = 0; attempt < MAX_CONNECTIONS; ++attempt) {
+        std::atomic<Entry*>& slot = table_[conn_id % MAX_CONNECTIONS];
+        Entry* current = slot.load(std::memory_order_relaxed);
+        if (!current) {
+            if (conn_id != connection->get_connection_id()) {
+                std::cout << "[RX Engine] Connection id " << connection->get_connection_id()
+                          << " shares a table slot with a live connection; using id " << conn_id << std::endl;
+                connection->initialize(conn_id, connection->get_params());
+            }
+            slot.store(new Entry{conn_id, std::move(connection)}, std::memory_order_seq_cst);
+            return true;
+        }
+        if (current->connection == connection) {
+            return true;
+        }
+        // Sequential ids walk the slots in order, so one free slot is found within a lap
+        conn_id = ConnectionIDAllocator::allocate() & SDRPacketHeader::CONN_ID_MASK;
+    }
+    std::cerr << "[RX Engine] Connection table full (" << MAX_CONNECTIONS << " connections)" << std::endl;
+    return false;
+}
+
+inline void RXEngine::unregister_connection(uint32_t conn_id) {
+    conn_id &= SDRPacketHeader::CONN_ID_MASK;
+    std::lock_guard<std::mutex> lock(table_mutex_);
+    std::atomic<Entry*>& slot = table_[conn_id % MAX_CONNECTIONS];
+    Entry* current = slot.load(std::memory_order_relaxed);
+    if (!current || current->conn_id != conn_id) {
+        return;
+    }
+    // Threads still routing to it keep the connection alive until they unpin
+    EpochDomain::instance().retire(slot.exchange(nullptr, std::memory_order_seq_cst));
+}
+
+inline ConnectionContext* RXEngine::lookup(uint32_t conn_id) const {
+    const Entry* entry = table_[conn_id % MAX_CONNECTIONS].load(std::memory_order_acquire);
+    if (!entry || entry->conn_id != conn_id) {
+        return nullptr;
+    }
+    return entry->connection.get();
+}
+
+inline void RXEngine::worker_func(size_t worker_idx) {
+    Worker& worker = *workers_[worker_idx];
+    const uint32_t batch = rx_batch_size_;
+
+    // Receive ring shared by this thread's sockets: header and payload of each
+    // slot are contiguous, so one iovec per datagram is enough
+    std::vector<uint8_t> ring(max_packet_size_ * batch);
+    std::vector<struct mmsghdr> msgs(batch);
+    std::vector<struct iovec> iovs(batch);
+    const size_t control_space = CMSG_SPACE(sizeof(int));
+    std::vector<uint8_t> control(worker.gro ? control_space * batch : 0);
+    std::vector<UDPReceiver::RxPacket> packets;
+    packets.reserve(batch);
+    for (uint32_t i = 0; i < batch; ++i) {
+        iovs[i].iov_base = ring.data() + i * max_packet_size_;
+        iovs[i].iov_len = max_packet_size_;
+        std::memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    std::vector<struct pollfd> pfds(worker.socket_fds.size());
+    for (size_t p = 0; p < pfds.size(); ++p) {
+        pfds[p].fd = worker.socket_fds[p];
+        pfds[p].events = POLLIN;
+    }
+
+    while (!should_stop_.load(std::memory_order_acquire)) {
+        for (auto& pfd : pfds) {
+            pfd.revents = 0;
+        }
+        int ready = poll(pfds.data(), pfds.size(), 100);
+        if (ready <= 0) {
+            if (ready < 0 && errno != EINTR) {
+                std::cerr << "[RX Engine] Poll failed: " << strerror(errno) << std::endl;
+                break;
+            }
+            continue;
+        }
+        for (const auto& pfd : pfds) {
+            if (pfd.revents & POLLIN) {
+                receive_batch(pfd.fd, worker.gro, ring, msgs, control, packets);
+            }
+        }
+    }
+}
+
+inline void RXEngine::receive_batch(int fd, bool gro, std::vector<uint8_t>& ring, std::vector<struct mmsghdr>& msgs,
+                                    std::vector<uint8_t>& control, std::vector<UDPReceiver::RxPacket>& packets) {
+    const uint32_t batch = static_cast<uint32_t>(msgs.size());
+    const size_t control_space = CMSG_SPACE(sizeof(int));
+    if (gro) {
+        for (uint32_t i = 0; i < batch; ++i) {
+            msgs[i].msg_hdr.msg_control = control.data() + i * control_space;
+            msgs[i].msg_hdr.msg_controllen = control_space;
+        }
+    }
+
+    int n = recvmmsg(fd, msgs.data(), batch, MSG_DONTWAIT, nullptr);
+    if (n <= 0) {
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            std::cerr << "[RX Engine] Recvmmsg failed: " << strerror(errno) << std::endl;
+        }
+        return;
+    }
+
+    // Pass 1: decode headers, splitting coalesced datagrams on the GRO segment size
+    packets.clear();
+    for (int i = 0; i < n; ++i) {
+        bool truncated = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+        msgs[i].msg_hdr.msg_flags = 0;
+        if (truncated) {
+            std::cerr << "[RX Engine] Datagram larger than " << max_packet_size_
+                      << " bytes truncated, dropping" << std::endl;
+            continue;
+        }
+        const uint8_t* slot = ring.data() + i * max_packet_size_;
+        size_t len = msgs[i].msg_len;
+        size_t segment_size = gro ? UDPReceiver::gro_segment_size(msgs[i].msg_hdr) : 0;
+        if (segment_size == 0 || segment_size >= len) {
+            segment_size = len;
+        }
+        for (size_t pos = 0; pos < len; pos += segment_size) {
+            UDPReceiver::RxPacket pkt;
+            if (!UDPReceiver::parse_datagram(slot + pos, std::min(segment_size, len - pos), pkt.header,
+                                             pkt.payload_len)) {
+                continue;
+            }
+            pkt.payload = slot + pos + pkt.header.header_size;
+            packets.push_back(pkt);
+        }
+    }
+
+    // Pass 2: route by conn_id; consecutive packets of one connection and message
+    // generation share the table lookups and the writer reference
+    EpochDomain::Guard pinned(EpochDomain::instance());
+    UDPReceiver::WriteRef writer;
+    ConnectionContext* connection = nullptr;
+    uint32_t cached_conn_id = UINT32_MAX;
+    uint32_t cached_msg_id = UINT32_MAX;
+    uint32_t cached_generation = 0;
+    uint64_t accepted = 0;
+    uint64_t unrouted = 0;
+
+    for (const UDPReceiver::RxPacket& pkt : packets) {
+        const PacketInfo& header = pkt.header;
+        if (header.conn_id != cached_conn_id) {
+            cached_conn_id = header.conn_id;
+            cached_msg_id = UINT32_MAX;
+            connection = lookup(cached_conn_id);
+            writer.reset();
+        }
+        if (!connection) {
+            unrouted++;
+            continue;
+        }
+        if (header.msg_id != cached_msg_id || header.transfer_id != cached_generation) {
+            cached_msg_id = header.msg_id;
+            cached_generation = header.transfer_id;
+            MessageContext* msg_ctx = connection->get_message(cached_msg_id);
+            writer.reset(msg_ctx && msg_ctx->begin_write(cached_generation, header.generation_mask) ? msg_ctx
+                                                                                                  : nullptr);
+        }
+        if (UDPReceiver::process_packet(writer.ctx, header, pkt.payload, pkt.payload_len)) {
+            accepted++;
+        }
+    }
+
+    if (accepted) {
+        packets_received_.fetch_add(accepted, std::memory_order_relaxed);
+    }
+    if (unrouted) {
+        packets_unrouted_.fetch_add(unrouted, std::memory_order_relaxed);
+    }
+}
+
+} // namespace sdr
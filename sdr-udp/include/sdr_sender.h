@@ -0,0 +1,555 @@
+#pragma once
+
+#include "sdr_packet.h"
+#include "sdr_header_codec.h"
+#include "sdr_pacer.h"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+namespace sdr {
+
+// One header slot per cache line so slots handed to the kernel never share a line
+struct alignas(64) HeaderSlot {
+    uint8_t bytes[sizeof(SDRPacketHeader)];   // Wire bytes of any layout (header_codec)
+};
+
+// Per-connection packet builder
+// Builds SDR headers in place in a preallocated slab and points the payload
+// iovec straight at the user buffer, so payload bytes are never copied before
+// the syscall. Slots are handed out round-robin; a slot stays valid until
+// num_slots() further packets have been built.
+class PacketBuilder {
+public:
+    static constexpr size_t DEFAULT_SLOTS = 256;
+
+    explicit PacketBuilder(size_t num_slots = DEFAULT_SLOTS);
+
+    // Bind the builder to a message; per-message header fields are encoded once here.
+    // conn_id is the receiver's connection id from CTS (0 when not known); format is
+    // the header layout CTS granted. With checksum (32-byte layouts only) every
+    // packet is stamped with the CRC32C of its header and payload as it is built.
+    void set_message(uint32_t transfer_id, uint32_t msg_id, uint16_t packets_per_chunk,
+                     uint32_t mtu_bytes, const void* data, size_t length, uint32_t conn_id = 0,
+                     HeaderFormat format = HeaderFormat::STANDARD, bool checksum = false);
+
+    // Mark subsequently built headers as GSO segments (FLAG_GSO_SEGMENT)
+    void set_segmented(bool segmented);
+
+    // Build header for packet_offset and fill iov[0] (header) and iov[1] (payload).
+    // Returns total wire bytes, or 0 if the offset is outside the bound message.
+    size_t build(uint32_t packet_offset, struct iovec iov[2]);
+
+    uint32_t total_packets() const { return total_packets_; }
+    uint32_t mtu_bytes() const { return mtu_bytes_; }
+    size_t header_size() const { return header_size_; }
+    size_t num_slots() const { return num_slots_; }
+
+private:
+    std::unique_ptr<HeaderSlot[]> slots_;
+    size_t num_slots_;
+    size_t next_slot_;
+
+    HeaderSlot template_;        // Per-message header, already encoded for the wire
+    uint32_t msg_id_;
+    HeaderFormat format_;
+    size_t header_size_;         // Wire size of format_
+    bool checksum_;
+    const uint8_t* data_;
+    size_t length_;
+    uint32_t mtu_bytes_;
+    uint16_t packets_per_chunk_;
+    uint32_t total_packets_;
+};
+
+// Batched UDP transmit stage
+// Owns one connected UDP socket per channel for the life of the connection.
+// Builds packets with a PacketBuilder, queues them in an mmsghdr vector and
+// flushes each channel's batch with one sendmmsg on that channel's socket.
+// Packet i goes to channel base_port + i % num_channels, matching the
+// receiver's per-channel workers. With GSO enabled each mmsghdr carries a
+// train of packets that the kernel splits on the header + MTU boundary
+// (UDP_SEGMENT).
+class UDPSender {
+public:
+    static constexpr uint32_t DEFAULT_BATCH_SIZE = 64;
+    static constexpr uint32_t MAX_BATCH_SIZE = 1024; // UIO_MAXIOV caps sendmmsg vlen
+    static constexpr uint32_t GSO_MAX_SEGMENTS = 64;  // UDP_MAX_SEGMENTS on older kernels
+    static constexpr size_t GSO_MAX_BYTES = 65507;    // Largest IPv4 UDP payload
+    static constexpr int DEFAULT_SNDBUF_BYTES = 8 * 1024 * 1024;
+
+    explicit UDPSender(uint32_t batch_size = DEFAULT_BATCH_SIZE);
+    ~UDPSender();
+
+    UDPSender(const UDPSender&) = delete;
+    UDPSender& operator=(const UDPSender&) = delete;
+
+    // Create and connect one socket per channel (base_port + ch). Sockets are
+    // kept if the destination is unchanged, so this is cheap to call per message.
+    // first_channel/channel_step restrict the sender to channels first, first + step, ...
+    // (one TX thread's share); packets of other channels are skipped by send_range.
+    bool open_channels(const char* ip, uint16_t base_port, uint16_t num_channels,
+                       int sndbuf_bytes = DEFAULT_SNDBUF_BYTES,
+                       uint16_t first_channel = 0, uint16_t channel_step = 1);
+    void close_channels();
+    size_t num_channels() const { return channel_fds_.size(); }
+
+    // Change batch size (0 keeps the default); drops nothing already sent
+    void set_batch_size(uint32_t batch_size);
+    uint32_t batch_size() const { return batch_size_; }
+
+    PacketBuilder& builder() { return *builder_; }
+
+    // Probe the channel sockets for UDP_SEGMENT support and send GSO trains from
+    // now on. Returns false (GSO stays off) when the kernel lacks it. Call before
+    // builder().set_message(), since enabling may resize the header slab.
+    bool enable_gso();
+    void disable_gso();
+    bool gso_enabled() const { return gso_enabled_; }
+
+    // Pace every flushed batch through a (possibly shared) token bucket; null disables
+    void set_pacer(std::shared_ptr<TokenBucket> pacer) { pacer_ = std::move(pacer); }
+    // Kernel pacing hint (SO_MAX_PACING_RATE, honoured by the fq qdisc) for each
+    // owned socket; 0 clears it. Returns false if the option is unsupported.
+    bool set_socket_pacing_rate(uint64_t bytes_per_sec);
+
+    // Build and send packets [first_packet, first_packet + count) of the bound
+    // message. Returns the number of packets accepted by the kernel.
+    size_t send_range(uint32_t first_packet, uint32_t count);
+
+    uint64_t packets_failed() const { return packets_failed_; }
+    int last_error() const { return last_errno_; }
+
+private:
+    uint32_t batch_size_;
+    std::unique_ptr<PacketBuilder> builder_;
+    std::vector<struct mmsghdr> msgs_;
+    std::vector<struct iovec> iovs_;          // Two per queued packet
+    std::vector<uint32_t> msg_packets_;       // Packets carried by each queued mmsghdr
+    std::vector<uint8_t> control_;            // UDP_SEGMENT cmsg per queued train
+    std::vector<int> channel_fds_;            // Connected socket per channel, -1 if not owned
+    struct in_addr dest_addr_;
+    uint16_t dest_base_port_;
+    uint16_t first_channel_;
+    uint16_t channel_step_;
+    uint32_t pending_;
+    size_t pending_iovs_;
+    bool gso_enabled_;
+    std::shared_ptr<TokenBucket> pacer_;
+    size_t pending_bytes_;                    // Wire bytes queued since the last flush
+    uint64_t packets_failed_;
+    int last_errno_;
+
+    static constexpr size_t GSO_CONTROL_SPACE = CMSG_SPACE(sizeof(uint16_t));
+
+    void resize_buffers();
+    // Segments per GSO train for the bound message, or 0 to send packets singly
+    uint32_t gso_segments() const;
+    // Send each header/payload pair of a train as its own datagram
+    size_t send_unsegmented(int fd, const struct msghdr& train);
+    size_t flush(int fd);
+};
+
+// Implementation
+inline PacketBuilder::PacketBuilder(size_t num_slots)
+    : slots_(std::make_unique<HeaderSlot[]>(std::max<size_t>(1, num_slots))),
+      num_slots_(std::max<size_t>(1, num_slots)), next_slot_(0),
+      msg_id_(0), format_(HeaderFormat::STANDARD), header_size_(sizeof(SDRPacketHeader)), checksum_(false),
+      data_(nullptr), length_(0), mtu_bytes_(0), packets_per_chunk_(0), total_packets_(0) {
+    std::memset(&template_, 0, sizeof(template_));
+}
+
+inline void PacketBuilder::set_message(uint32_t transfer_id, uint32_t msg_id, uint16_t packets_per_chunk,
+                                       uint32_t mtu_bytes, const void* data, size_t length, uint32_t conn_id,
+                                       HeaderFormat format, bool checksum) {
+    data_ = static_cast<const uint8_t*>(data);
+    length_ = length;
+    mtu_bytes_ = std::min<uint32_t>(mtu_bytes, SDRPacket::MAX_PAYLOAD_SIZE);
+    packets_per_chunk_ = packets_per_chunk;
+    total_packets_ = mtu_bytes_ ? static_cast<uint32_t>((length + mtu_bytes_ - 1) / mtu_bytes_) : 0;
+
+    format_ = format;
+    header_size_ = sdr::header_size(format);
+    msg_id_ = msg_id;
+    checksum_ = checksum && format != HeaderFormat::COMPACT;
+
+    header_codec::HeaderFields fields{};
+    fields.type = static_cast<uint8_t>(PacketType::DATA);
+    fields.flags = checksum_ ? FLAG_CRC32C : 0;
+    fields.transfer_id = transfer_id;
+    fields.msg_id = msg_id;
+    fields.packets_per_chunk = packets_per_chunk;
+    fields.conn_id = conn_id & SDRPacketHeader::CONN_ID_MASK;
+    std::memset(&template_, 0, sizeof(template_));
+    header_codec::encode(format_, fields, template_.bytes);
+}
+
+inline void PacketBuilder::set_segmented(bool segmented) {
+    uint8_t& flags = template_.bytes[header_codec::flags_offset(format_)];
+    if (segmented) {
+        flags |= FLAG_GSO_SEGMENT;
+    } else {
+        flags &= static_cast<uint8_t>(~FLAG_GSO_SEGMENT);
+    }
+}
+
+inline size_t PacketBuilder::build(uint32_t packet_offset, struct iovec iov[2]) {
+    if (packet_offset >= total_packets_) {
+        return 0;
+    }
+
+    size_t data_offset = static_cast<size_t>(packet_offset) * mtu_bytes_;
+    size_t payload_len = std::min(static_cast<size_t>(mtu_bytes_), length_ - data_offset);
+
+    HeaderSlot& slot = slots_[next_slot_];
+    next_slot_ = (next_slot_ + 1 == num_slots_) ? 0 : next_slot_ + 1;
+
+    // Only offset, chunk and length vary per packet
+    std::memcpy(&slot, &template_, header_size_);
+    header_codec::patch(format_, slot.bytes, msg_id_, packet_offset,
+                        packets_per_chunk_ ? packet_offset / packets_per_chunk_ : 0,
+                        static_cast<uint16_t>(payload_len));
+    if (checksum_) {
+        header_codec::stamp_crc(slot.bytes, data_ + data_offset, payload_len);
+    }
+
+    iov[0].iov_base = slot.bytes;
+    iov[0].iov_len = header_size_;
+    iov[1].iov_base = const_cast<uint8_t*>(data_ + data_offset);
+    iov[1].iov_len = payload_len;
+    return header_size_ + payload_len;
+}
+
+inline UDPSender::UDPSender(uint32_t batch_size)
+    : batch_size_(0), dest_base_port_(0), first_channel_(0), channel_step_(1), pending_(0), pending_iovs_(0), gso_enabled_(false),
+      pending_bytes_(0),
+      packets_failed_(0), last_errno_(0) {
+    dest_addr_.s_addr = INADDR_ANY;
+    set_batch_size(batch_size);
+}
+
+inline UDPSender::~UDPSender() {
+    close_channels();
+}
+
+inline bool UDPSender::open_channels(const char* ip, uint16_t base_port, uint16_t num_channels,
+                                     int sndbuf_bytes, uint16_t first_channel, uint16_t channel_step) {
+    struct sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    if (!ip || inet_pton(AF_INET, ip, &addr.sin_addr) <= 0) {
+        return false;
+    }
+
+    num_channels = std::max<uint16_t>(1, num_channels);
+    channel_step = std::max<uint16_t>(1, channel_step);
+    if (first_channel >= num_channels) {
+        return false;
+    }
+    if (channel_fds_.size() == num_channels && dest_base_port_ == base_port &&
+        dest_addr_.s_addr == addr.sin_addr.s_addr &&
+        first_channel_ == first_channel && channel_step_ == channel_step) {
+        return true;
+    }
+
+    close_channels();
+    channel_fds_.assign(num_channels, -1);
+    for (uint32_t ch = first_channel; ch < num_channels; ch += channel_step) {
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            last_errno_ = errno;
+            close_channels();
+            return false;
+        }
+        if (sndbuf_bytes > 0 &&
+            setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf_bytes, sizeof(sndbuf_bytes)) < 0) {
+            std::cerr << "[UDP Sender] Warning: Failed to set SO_SNDBUF: " << strerror(errno) << std::endl;
+        }
+        // Connected sockets resolve the route once instead of per packet
+        addr.sin_port = htons(static_cast<uint16_t>(base_port + ch));
+        if (connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) < 0) {
+            last_errno_ = errno;
+            close(fd);
+            close_channels();
+            return false;
+        }
+        channel_fds_[ch] = fd;
+    }
+
+    dest_addr_ = addr.sin_addr;
+    dest_base_port_ = base_port;
+    first_channel_ = first_channel;
+    channel_step_ = channel_step;
+    if (gso_enabled_ && !enable_gso()) {
+        disable_gso();
+    }
+    return true;
+}
+
+inline void UDPSender::close_channels() {
+    for (int fd : channel_fds_) {
+        if (fd >= 0) close(fd);
+    }
+    channel_fds_.clear();
+    dest_addr_.s_addr = INADDR_ANY;
+    dest_base_port_ = 0;
+}
+
+inline void UDPSender::set_batch_size(uint32_t batch_size) {
+    if (batch_size == 0) batch_size = DEFAULT_BATCH_SIZE;
+    batch_size = std::min(batch_size, MAX_BATCH_SIZE);
+    if (batch_size == batch_size_) {
+        return;
+    }
+
+    batch_size_ = batch_size;
+    resize_buffers();
+}
+
+inline void UDPSender::resize_buffers() {
+    // Headers must outlive the batch they are queued in
+    size_t packets_per_batch = static_cast<size_t>(batch_size_) * (gso_enabled_ ? GSO_MAX_SEGMENTS : 1);
+    size_t slots = std::max<size_t>(PacketBuilder::DEFAULT_SLOTS, packets_per_batch);
+    if (!builder_ || builder_->num_slots() != slots) {
+        builder_ = std::make_unique<PacketBuilder>(slots);
+    }
+    msgs_.assign(batch_size_, mmsghdr{});
+    msg_packets_.assign(batch_size_, 0);
+    iovs_.assign(packets_per_batch * 2, iovec{});
+    control_.assign(gso_enabled_ ? batch_size_ * GSO_CONTROL_SPACE : 0, 0);
+    pending_ = 0;
+    pending_iovs_ = 0;
+    pending_bytes_ = 0;
+}
+
+inline bool UDPSender::enable_gso() {
+#ifdef UDP_SEGMENT
+    int segment_size = 0;
+    socklen_t len = sizeof(segment_size);
+    if (channel_fds_.empty() ||
+        getsockopt(channel_fds_[first_channel_], SOL_UDP, UDP_SEGMENT, &segment_size, &len) < 0) {
+        last_errno_ = errno;
+        disable_gso();
+        return false;
+    }
+    if (!gso_enabled_) {
+        gso_enabled_ = true;
+        resize_buffers();
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline bool UDPSender::set_socket_pacing_rate(uint64_t bytes_per_sec) {
+#ifdef SO_MAX_PACING_RATE
+    // The option takes an unsigned long; ~0 means unlimited
+    unsigned long rate = bytes_per_sec ? static_cast<unsigned long>(bytes_per_sec) : ~0UL;
+    bool ok = true;
+    for (int fd : channel_fds_) {
+        if (fd >= 0 && setsockopt(fd, SOL_SOCKET, SO_MAX_PACING_RATE, &rate, sizeof(rate)) < 0) {
+            last_errno_ = errno;
+            ok = false;
+        }
+    }
+    return ok;
+#else
+    (void)bytes_per_sec;
+    return false;
+#endif
+}
+
+inline void UDPSender::disable_gso() {
+    if (gso_enabled_) {
+        gso_enabled_ = false;
+        resize_buffers();
+    }
+}
+
+inline uint32_t UDPSender::gso_segments() const {
+    if (!gso_enabled_ || builder_->mtu_bytes() == 0) {
+        return 0;
+    }
+    size_t segment_size = builder_->header_size() + builder_->mtu_bytes();
+    uint32_t segments = static_cast<uint32_t>(std::min<size_t>(GSO_MAX_SEGMENTS, GSO_MAX_BYTES / segment_size));
+    return segments > 1 ? segments : 0;
+}
+
+inline size_t UDPSender::send_range(uint32_t first_packet, uint32_t count) {
+    if (channel_fds_.empty()) {
+        return 0;
+    }
+
+    uint32_t segments = gso_segments();
+    builder_->set_segmented(segments > 0);
+    uint32_t packets_per_msg = segments > 0 ? segments : 1;
+#ifdef UDP_SEGMENT
+    const uint16_t segment_size = static_cast<uint16_t>(builder_->header_size() + builder_->mtu_bytes());
+#endif
+    const uint32_t num_channels = static_cast<uint32_t>(channel_fds_.size());
+    const uint64_t end = std::min<uint64_t>(static_cast<uint64_t>(first_packet) + count, builder_->total_packets());
+    const uint64_t window_packets = static_cast<uint64_t>(num_channels) * batch_size_ * packets_per_msg;
+    // When paced, flush at most one burst at a time so batches do not defeat the bucket
+    uint32_t flush_threshold = batch_size_;
+    auto set_flush_threshold = [&]() {
+        if (pacer_ && pacer_->enabled()) {
+            size_t msg_bytes = (builder_->header_size() + builder_->mtu_bytes()) * packets_per_msg;
+            flush_threshold = static_cast<uint32_t>(std::max<size_t>(1, std::min<size_t>(batch_size_,
+                                                                     pacer_->burst_bytes() / msg_bytes)));
+        }
+    };
+    set_flush_threshold();
+    // A flush that had GSO rejected turned it off; the rest of the range goes out
+    // one packet per message, so only that batch pays for the fallback
+    auto flush_batch = [&](int fd) {
+        size_t flushed = flush(fd);
+        if (packets_per_msg > 1 && !gso_enabled_) {
+            packets_per_msg = 1;
+            set_flush_threshold();
+        }
+        return flushed;
+    };
+
+    // Walk the range in windows of one batch per channel. Channel ch carries
+    // offsets start, start + C, ...; under GSO only the message's last packet
+    // can be short and it is always last in its train.
+    size_t sent = 0;
+    for (uint64_t window = first_packet; window < end; window += window_packets) {
+        uint64_t window_end = std::min(end, window + window_packets);
+        for (uint64_t start = window; start < window_end && start < window + num_channels; ++start) {
+            int fd = channel_fds_[start % num_channels];
+            if (fd < 0) {
+                continue; // Channel owned by another sender
+            }
+            uint64_t offset = start;
+            while (offset < window_end) {
+                struct iovec* iov = &iovs_[pending_iovs_];
+                uint32_t built = 0;
+                for (; built < packets_per_msg && offset < window_end; offset += num_channels) {
+                    size_t wire_bytes = builder_->build(static_cast<uint32_t>(offset), &iov[2 * built]);
+                    if (wire_bytes == 0) {
+                        break;
+                    }
+                    pending_bytes_ += wire_bytes;
+                    built++;
+                }
+                if (built == 0) {
+                    break;
+                }
+
+                struct msghdr& hdr = msgs_[pending_].msg_hdr;
+                hdr.msg_name = nullptr;
+                hdr.msg_namelen = 0;
+                hdr.msg_iov = iov;
+                hdr.msg_iovlen = 2 * built;
+                hdr.msg_control = nullptr;
+                hdr.msg_controllen = 0;
+                hdr.msg_flags = 0;
+#ifdef UDP_SEGMENT
+                if (built > 1) {
+                    hdr.msg_control = &control_[pending_ * GSO_CONTROL_SPACE];
+                    hdr.msg_controllen = GSO_CONTROL_SPACE;
+                    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+                    cmsg->cmsg_level = SOL_UDP;
+                    cmsg->cmsg_type = UDP_SEGMENT;
+                    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                    std::memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+                }
+#endif
+                msg_packets_[pending_] = built;
+                pending_iovs_ += 2 * built;
+
+                if (++pending_ == flush_threshold) {
+                    sent += flush_batch(fd);
+                }
+            }
+            sent += flush_batch(fd);
+        }
+    }
+    return sent;
+}
+
+inline size_t UDPSender::send_unsegmented(int fd, const struct msghdr& train) {
+    size_t sent = 0;
+    for (size_t i = 0; i + 1 < train.msg_iovlen; i += 2) {
+        struct msghdr hdr;
+        std::memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_iov = &train.msg_iov[i];
+        hdr.msg_iovlen = 2;
+        ssize_t rc;
+        do {
+            rc = sendmsg(fd, &hdr, 0);
+        } while (rc < 0 && errno == EINTR);
+        if (rc < 0) {
+            last_errno_ = errno;
+            packets_failed_++;
+        } else {
+            sent++;
+        }
+    }
+    return sent;
+}
+
+inline size_t UDPSender::flush(int fd) {
+    size_t sent = 0;
+    uint32_t done = 0;
+    bool stale_error_cleared = false;
+    if (pacer_ && pending_bytes_ > 0) {
+        pacer_->acquire(pending_bytes_);
+    }
+    pending_bytes_ = 0;
+    while (done < pending_) {
+        int n = sendmmsg(fd, &msgs_[done], pending_ - done, 0);
+        if (n > 0) {
+            // Partial batch: resubmit the remainder
+            for (int i = 0; i < n; ++i) {
+                sent += msg_packets_[done + i];
+            }
+            done += static_cast<uint32_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && errno == ECONNREFUSED && !stale_error_cleared) {
+            // Connected sockets report an earlier ICMP unreachable on the next send; retry once
+            stale_error_cleared = true;
+            continue;
+        }
+        last_errno_ = errno;
+        if (msgs_[done].msg_hdr.msg_controllen > 0 &&
+            (errno == EIO || errno == EINVAL || errno == ENOPROTOOPT || errno == EOPNOTSUPP)) {
+            // Kernel or device refused segmentation: send the rest of the batch
+            // packet by packet. The rest of the range and later ones go out
+            // unsegmented too (send_range checks gso_enabled_ after each flush).
+            std::cerr << "[UDP Sender] GSO rejected (" << strerror(errno)
+                      << "), falling back to per-packet send" << std::endl;
+            for (; done < pending_; ++done) {
+                sent += send_unsegmented(fd, msgs_[done].msg_hdr);
+            }
+            gso_enabled_ = false;
+            builder_->set_segmented(false);
+            break;
+        }
+        // The head message was rejected; count its packets as failed and move past it
+        packets_failed_ += msg_packets_[done];
+        done++;
+    }
+    pending_ = 0;
+    pending_iovs_ = 0;
+    return sent;
+}
+
+} // namespace sdr
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "sdr_sender.h"
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+
+namespace sdr {
+
+// Multi-threaded transmit engine
+// Runs one TX thread per share of the channels: thread t owns channels
+// t, t + N, ... with its own connected sockets, PacketBuilder and batch
+// buffers, so threads never contend on a socket or header slab. A send is
+// split by channel stride across all threads; each thread publishes progress
+// through its own counter, which callers merge into their send handle.
+class TXEngine {
+public:
+    TXEngine();
+    ~TXEngine();
+
+    TXEngine(const TXEngine&) = delete;
+    TXEngine& operator=(const TXEngine&) = delete;
+
+    // Open channel sockets and start min(num_threads, num_channels) threads.
+    // pin_cores: pin thread t to core t % hardware_concurrency.
+    // Calling again with the same layout keeps the running threads.
+    bool start(const char* ip, uint16_t base_port, uint16_t num_channels,
+               uint32_t num_threads, bool pin_cores);
+    void stop();
+    bool is_running() const { return !workers_.empty(); }
+    uint32_t num_threads() const { return static_cast<uint32_t>(workers_.size()); }
+
+    // Apply batch size, GSO and pacing to every thread; only call while no send is
+    // in flight. Threads share the pacer, so its rate caps the whole connection.
+    void configure(uint32_t batch_size, bool gso, std::shared_ptr<TokenBucket> pacer = nullptr);
+    bool gso_enabled() const;
+
+    // Send packets [first_packet, first_packet + count) of a message on all
+    // threads and wait for them. Returns packets accepted by the kernel.
+    size_t send_range(uint32_t transfer_id, uint32_t msg_id, uint16_t packets_per_chunk,
+                      uint32_t mtu_bytes, const void* data, size_t length,
+                      uint32_t first_packet, uint32_t count, uint32_t conn_id = 0,
+                      HeaderFormat format = HeaderFormat::STANDARD, bool checksum = false);
+
+    // Packets sent by all threads since start (readable while a send is in flight)
+    uint64_t packets_sent() const;
+    uint64_t packets_failed() const;
+    int last_error() const;
+
+private:
+    struct Job {
+        uint32_t transfer_id;
+        uint32_t msg_id;
+        uint16_t packets_per_chunk;
+        uint32_t mtu_bytes;
+        const void* data;
+        size_t length;
+        uint32_t first_packet;
+        uint32_t count;
+        uint32_t conn_id;
+        HeaderFormat format;
+        bool checksum;
+    };
+
+    struct alignas(64) Worker {
+        std::thread thread;
+        UDPSender sender;
+        std::atomic<uint64_t> packets_sent{0};   // Lifetime progress, updated per slice
+        size_t job_sent{0};                      // Result of the current job (guarded by mutex_)
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex mutex_;
+    std::condition_variable job_cv_;
+    std::condition_variable done_cv_;
+    Job job_;
+    uint64_t job_seq_;
+    size_t pending_workers_;
+    bool stop_;
+
+    struct in_addr dest_addr_;
+    uint16_t dest_base_port_;
+    uint16_t num_channels_;
+    bool pin_cores_;
+
+    void worker_func(size_t worker_idx);
+};
+
+// Implementation
+inline TXEngine::TXEngine()
+    : job_(), job_seq_(0), pending_workers_(0), stop_(false),
+      dest_base_port_(0), num_channels_(0), pin_cores_(false) {
+    dest_addr_.s_addr = INADDR_ANY;
+}
+
+inline TXEngine::~TXEngine() {
+    stop();
+}
+
+inline bool TXEngine::start(const char* ip, uint16_t base_port, uint16_t num_channels,
+                            uint32_t num_threads, bool pin_cores) {
+    struct in_addr addr;
+    if (!ip || inet_pton(AF_INET, ip, &addr) <= 0) {
+        return false;
+    }
+    num_channels = std::max<uint16_t>(1, num_channels);
+    uint32_t threads = std::max<uint32_t>(1, std::min<uint32_t>(num_threads, num_channels));
+    if (is_running() && workers_.size() == threads && num_channels_ == num_channels &&
+        dest_base_port_ == base_port && dest_addr_.s_addr == addr.s_addr && pin_cores_ == pin_cores) {
+        return true;
+    }
+
+    stop();
+    stop_ = false;
+    job_seq_ = 0;
+    for (uint32_t t = 0; t < threads; ++t) {
+        auto worker = std::make_unique<Worker>();
+        if (!worker->sender.open_channels(ip, base_port, num_channels, UDPSender::DEFAULT_SNDBUF_BYTES,
+                                          static_cast<uint16_t>(t), static_cast<uint16_t>(threads))) {
+            std::cerr << "[TX Engine] Failed to open channel sockets for thread " << t << ": "
+                      << strerror(worker->sender.last_error()) << std::endl;
+            workers_.clear();
+            return false;
+        }
+        workers_.push_back(std::move(worker));
+    }
+
+    dest_addr_ = addr;
+    dest_base_port_ = base_port;
+    num_channels_ = num_channels;
+    pin_cores_ = pin_cores;
+    for (size_t t = 0; t < workers_.size(); ++t) {
+        workers_[t]->thread = std::thread(&TXEngine::worker_func, this, t);
+    }
+
+    std::cout << "[TX Engine] Started " << workers_.size() << " TX thread(s) over "
+              << num_channels_ << " channel(s)" << (pin_cores_ ? ", pinned" : "") << std::endl;
+    return true;
+}
+
+inline void TXEngine::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    job_cv_.notify_all();
+    for (auto& w : workers_) {
+        if (w->thread.joinable()) {
+            w->thread.join();
+        }
+    }
+    workers_.clear();
+    num_channels_ = 0;
+}
+
+inline void TXEngine::configure(uint32_t batch_size, bool gso, std::shared_ptr<TokenBucket> pacer) {
+    uint64_t socket_rate = (pacer && pacer->enabled() && num_channels_) ? pacer->rate() / num_channels_ : 0;
+    for (auto& w : workers_) {
+        w->sender.set_batch_size(batch_size);
+        if (!gso || !w->sender.enable_gso()) {
+            w->sender.disable_gso();
+        }
+        w->sender.set_pacer(pacer);
+        w->sender.set_socket_pacing_rate(socket_rate);
+    }
+}
+
+inline bool TXEngine::gso_enabled() const {
+    return !workers_.empty() && workers_.front()->sender.gso_enabled();
+}
+
+inline size_t TXEngine::send_range(uint32_t transfer_id, uint32_t msg_id, uint16_t packets_per_chunk,
+                                   uint32_t mtu_bytes, const void* data, size_t length,
+                                   uint32_t first_packet, uint32_t count, uint32_t conn_id,
+                                   HeaderFormat format, bool checksum) {
+    if (workers_.empty()) {
+        return 0;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_ = Job{transfer_id, msg_id, packets_per_chunk, mtu_bytes, data, length, first_packet, count, conn_id,
+               format, checksum};
+    for (auto& w : workers_) {
+        w->job_sent = 0;
+    }
+    pending_workers_ = workers_.size();
+    ++job_seq_;
+    job_cv_.notify_all();
+    done_cv_.wait(lock, [&] { return pending_workers_ == 0; });
+
+    size_t sent = 0;
+    for (auto& w : workers_) {
+        sent += w->job_sent;
+    }
+    return sent;
+}
+
+inline uint64_t TXEngine::packets_sent() const {
+    uint64_t total = 0;
+    for (const auto& w : workers_) {
+        total += w->packets_sent.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+inline uint64_t TXEngine::packets_failed() const {
+    uint64_t total = 0;
+    for (const auto& w : workers_) {
+        total += w->sender.packets_failed();
+    }
+    return total;
+}
+
+inline int TXEngine::last_error() const {
+    for (const auto& w : workers_) {
+        if (w->sender.last_error() != 0) {
+            return w->sender.last_error();
+        }
+    }
+    return 0;
+}
+
+inline void TXEngine::worker_func(size_t worker_idx) {
+    Worker& w = *workers_[worker_idx];
+
+    if (pin_cores_) {
+        unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(worker_idx % cores, &cpus);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (rc != 0) {
+            std::cerr << "[TX Engine] Warning: Failed to pin thread " << worker_idx
+                      << ": " << strerror(rc) << std::endl;
+        }
+    }
+
+    uint64_t seen_seq = 0;
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_cv_.wait(lock, [&] { return stop_ || job_seq_ != seen_seq; });
+            if (stop_) {
+                return;
+            }
+            seen_seq = job_seq_;
+            job = job_;
+        }
+
+        w.sender.builder().set_message(job.transfer_id, job.msg_id, job.packets_per_chunk,
+                                       job.mtu_bytes, job.data, job.length, job.conn_id, job.format,
+                                       job.checksum);
+        uint64_t end = std::min<uint64_t>(static_cast<uint64_t>(job.first_packet) + job.count,
+                                          w.sender.builder().total_packets());
+
+        // Send in slices so progress is visible while the transfer runs
+        const uint64_t slice = static_cast<uint64_t>(num_channels_) * w.sender.batch_size() *
+                               (w.sender.gso_enabled() ? UDPSender::GSO_MAX_SEGMENTS : 4);
+        size_t sent = 0;
+        for (uint64_t offset = job.first_packet; offset < end; offset += slice) {
+            uint32_t slice_count = static_cast<uint32_t>(std::min(slice, end - offset));
+            size_t n = w.sender.send_range(static_cast<uint32_t>(offset), slice_count);
+            w.packets_sent.fetch_add(n, std::memory_order_relaxed);
+            sent += n;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            w.job_sent = sent;
+            if (--pending_workers_ == 0) {
+                done_cv_.notify_all();
+            }
+        }
+    }
+}
+
+} // namespace sdr
@@ -2,6 +2,13 @@
 
 #include <cstdint>
 #include <string>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <memory>
+#include <optional>
 
 namespace sdr {
 
@@ -17,7 +24,8 @@ enum class ControlMsgType : uint8_t {
     SR_NACK = 7,        // Selective Repeat NACK (gap hint or timeout)
     EC_ACK = 8,         // Erasure coding ACK (decode success)
     EC_NACK = 9,        // Erasure coding NACK (decode failure / retry)
-    EC_FALLBACK_SR = 10 // Receiver requests SR fallback for EC
+    EC_FALLBACK_SR = 10,// Receiver requests SR fallback for EC
+    SR_BITMAP = 11      // Selective Repeat bitmap window past the ACK's (precedes SR_ACK/SR_NACK)
 };
 
 // Connection parameters structure (used in OFFER and CTS)
@@ -28,7 +36,7 @@ struct ConnectionParams {
     uint32_t packet_bytes;          // Size of each packet payload (usually MTU)
     uint32_t chunk_bytes;            // Size of each chunk (multiple of packet_bytes)
     uint16_t packets_per_chunk;      // Number of packets per chunk (P)
-    uint16_t total_chunks;           // Total number of chunks (C)
+    uint32_t total_chunks;           // Total number of chunks (C)
     uint16_t fec_k;                  // FEC data chunks (for future use)
     uint16_t fec_m;                  // FEC parity chunks (for future use)
     uint32_t max_inflight;           // Maximum in-flight messages
@@ -36,31 +44,82 @@ struct ConnectionParams {
     uint32_t rtt_alpha_ms;           // RTT alpha coefficient (for future SR use)
     uint16_t num_channels;           // Number of UDP channels (Section 3.4)
     uint16_t channel_base_port;      // Base port; channels use base + id
+    uint32_t tx_batch_size;          // Packets per sendmmsg batch on the sender (0 = default)
+    uint32_t rx_batch_size;          // Datagrams per recvmmsg call on the receiver (0 = default)
+    uint32_t rx_direct_placement;    // Receiver scatters payloads straight into the user buffer (0 = off)
+    uint32_t tx_threads;             // Sender TX threads, one per channel share (0/1 = caller thread)
+    uint32_t tx_pin_cores;           // Pin TX thread t to core t (0 = no pinning)
+    uint32_t udp_offload;            // UDP_OFFLOAD_* bits (OFFER: sender wants GSO; CTS: granted + receiver GRO)
+    uint32_t pacing_burst;           // Token-bucket burst in bytes (0 = default)
+    uint32_t rx_completion_poll_us;  // Receiver frontend bitmap poller interval (0 = event-driven only, no thread)
+    uint32_t rx_shared_engine;       // Receive through the process-wide RXEngine instead of per-connection channel threads (0 = off)
+    uint32_t msg_id;                 // CTS: message slot the receiver posted; the sender stamps it on every packet
+    uint32_t packet_headers;         // PACKET_HEADER_* bits (OFFER: layouts the sender builds; CTS: the one to use, none = standard)
+    uint64_t pacing_rate;            // Data-path rate in bytes/sec (OFFER: sender cap; CTS: receiver's choice; 0 = unpaced)
     
     // Network parameters
     char udp_server_ip[16];          // Receiver's UDP server IP
     uint16_t udp_server_port;        // Receiver's UDP server port
 };
 
-// Control message structure (sent over TCP)
+// ConnectionParams::udp_offload bits
+constexpr uint32_t UDP_OFFLOAD_GSO = 1u << 0;  // Sender may transmit GSO trains (UDP_SEGMENT)
+constexpr uint32_t UDP_OFFLOAD_GRO = 1u << 1;  // Receiver coalesces with UDP_GRO and splits segments
+
+// ConnectionParams::packet_headers bits
+constexpr uint32_t PACKET_HEADER_WIDE = 1u << 0;     // SDRWideHeader: 64-bit packet offsets, 32-bit msg_id
+constexpr uint32_t PACKET_HEADER_COMPACT = 1u << 1;  // SDRCompactHeader: 12 bytes, per-message fields left to CTS
+constexpr uint32_t PACKET_HEADER_CRC32C = 1u << 2;   // FLAG_CRC32C on every packet (32-byte layouts only)
+
+// Control message (sent over TCP)
+// On the wire a message is a 6-byte frame header (magic, version, type, payload
+// length; integers little-endian) followed by TLV fields: a tag byte, a varint
+// length and the value. Integers inside values are LEB128 varints, zero fields
+// are omitted, and each type carries only its own groups: the parameters for
+// OFFER/CTS/ACCEPT/REJECT, chunk feedback for the ACK/NACK types. Bitmaps are
+// run-length coded (or raw words when that is shorter) and gaps delta coded.
+// Unknown tags are skipped, so fields can be added without a version bump.
 struct ControlMessage {
     uint16_t magic;                  // Magic number for validation (0xSDR0)
     ControlMsgType msg_type;
     uint32_t connection_id;          // Connection identifier
-    ConnectionParams params;         // Connection parameters
+    ConnectionParams params;         // Connection parameters (OFFER/CTS/ACCEPT/REJECT)
+    uint32_t acked_prefix;           // Chunk feedback: chunks in the complete prefix (cumulative ACK)
+    uint32_t total_chunks;           // Chunk feedback: chunks in the message
+    uint32_t nack_start;             // SR_NACK: first missing chunk
+    uint32_t nack_len;               // SR_NACK: chunks missing from nack_start
+    uint32_t bitmap_base;            // Chunk feedback: chunk id of chunk_bitmap bit 0 (a multiple of 64)
     uint16_t chunk_bitmap_words;     // Number of 64-bit words used in chunk_bitmap
-    uint64_t chunk_bitmap[16];       // Chunk bitmap snapshot (up to 1024 chunks)
+    uint64_t chunk_bitmap[16];       // Chunk bitmap snapshot (up to 1024 chunks from bitmap_base)
     uint16_t num_gaps;               // Number of gaps encoded
-    uint16_t gap_start[16];          // Gap starts (chunk ids)
-    uint16_t gap_len[16];            // Gap lengths
-    
-    // Serialization helpers
+    uint32_t gap_start[16];          // Gap starts (chunk ids)
+    uint32_t gap_len[16];            // Gap lengths
+    uint32_t ack_delay_us;           // SR feedback: how long the receiver held its newest completion
+
+    // Encode into buffer; returns the frame length, 0 if buffer_size is too small
     size_t serialize(uint8_t* buffer, size_t buffer_size) const;
+    // Decode one whole frame; false if it is malformed
     bool deserialize(const uint8_t* buffer, size_t buffer_size);
+    // Length of the frame starting at buffer, from its header (HEADER_SIZE bytes);
+    // 0 if the header is not a valid frame header
+    static size_t frame_length(const uint8_t* buffer);
     
     static constexpr uint16_t MAGIC_VALUE = 0x5344; // "SD" in ASCII
+    static constexpr uint8_t WIRE_VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 6;
+    static constexpr size_t MAX_WIRE_SIZE = 1024;   // Largest encoded message
 };
 
+class ControlReactor;
+class ControlChannel;
+struct ControlRttStats;
+
+using ControlHandler = std::function<void(const ControlMessage&)>;
+
+// Received control messages are read by the process-wide ControlReactor and
+// queued on the connection's ControlChannel; receive_message and expect wait on
+// that queue rather than in recv()
+
 // TCP Control Server (Receiver side)
 class TCPControlServer {
 public:
@@ -70,8 +129,22 @@ public:
     bool start_listening(uint16_t port);
     
     bool accept_connection();
+
+    // Accept the next client as a separate session. The session shares this
+    // server's listening socket but owns only its client socket, so any number
+    // can be open at once. Returns nullptr on failure; the caller deletes it.
+    TCPControlServer* accept_session();
     
+    // Next message of any type; false after 200 ms or once the client has gone
     bool receive_message(ControlMessage& msg);
+    bool receive_message(ControlMessage& msg, std::chrono::milliseconds timeout);
+
+    // Next message of one of the given types (others are discarded); empty on timeout or close
+    std::future<std::optional<ControlMessage>> expect(std::initializer_list<ControlMsgType> types,
+                                                      std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    // Handle every message of this type on the reactor thread instead of queueing it
+    void on_message(ControlMsgType type, ControlHandler handler);
     
     bool send_message(const ControlMessage& msg);
     
@@ -80,13 +153,20 @@ public:
     void stop();
     
     uint16_t get_listen_port() const { return listen_port_; }
-    int get_client_fd() const { return client_fd_; }
+    // -1 once the client has disconnected
+    int get_client_fd() const;
+    ControlRttStats rtt_stats() const;
     
 private:
     int listen_fd_;
     int client_fd_;
     uint16_t listen_port_;
     bool is_listening_;
+    std::shared_ptr<ControlReactor> reactor_;
+    std::shared_ptr<ControlChannel> channel_;
+
+    int accept_client();
+    bool attach_client(int fd);
 };
 
 // TCP Control Client (Sender side)
@@ -99,22 +179,38 @@ public:
     
     bool send_message(const ControlMessage& msg);
 
+    // Next message of any type; false after 200 ms or once the server has gone
     bool receive_message(ControlMessage& msg);
+    bool receive_message(ControlMessage& msg, std::chrono::milliseconds timeout);
+
+    // Next message of one of the given types (others are discarded); empty on timeout or close
+    std::future<std::optional<ControlMessage>> expect(std::initializer_list<ControlMsgType> types,
+                                                      std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+    // Handle every message of this type on the reactor thread instead of queueing it
+    void on_message(ControlMsgType type, ControlHandler handler);
     
     void disconnect();
     
-    bool is_connected() const { return is_connected_; }
+    bool is_connected() const;
+    ControlRttStats rtt_stats() const;
     
 private:
     int socket_fd_;
     bool is_connected_;
+    std::shared_ptr<ControlReactor> reactor_;
+    std::shared_ptr<ControlChannel> channel_;
 };
 
+// Connection ids are carried in the 24-bit conn_id of every data packet, so they
+// stay nonzero and within that width (wrapping after 2^24 - 1 connections)
 class ConnectionIDAllocator {
 public:
+    static constexpr uint32_t MAX_ID = 0xFFFFFF;
+
     static uint32_t allocate() {
-        static uint32_t next_id = 1;
-        return next_id++;
+        static std::atomic<uint32_t> next_id{0};
+        return next_id.fetch_add(1, std::memory_order_relaxed) % MAX_ID + 1;
     }
     
     static void reset() {
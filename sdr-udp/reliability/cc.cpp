@@ -0,0 +1,237 @@
+#include "reliability/cc.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sdr::reliability {
+
+namespace {
+
+constexpr int64_t DEFAULT_RECOVERY_US = 100000;   // Loss-reaction hold-off before the first RTT sample
+
+// Loss-based AIMD: slow start to ssthresh, then one chunk per window per round;
+// halve the window at most once per RTT on loss, collapse it on RTO.
+class AimdController : public CongestionController {
+public:
+    explicit AimdController(const CCConfig& cfg)
+        : cfg_(cfg), cwnd_(cfg.initial_cwnd_chunks), ssthresh_(HUGE_VAL), srtt_us_(0), recovery_end_us_(0) {
+        clamp();
+    }
+
+    CCAlgorithm algorithm() const override { return CCAlgorithm::AIMD; }
+
+    void on_feedback(const CCFeedback& fb) override {
+        if (fb.rtt_us > 0) {
+            srtt_us_ = srtt_us_ == 0 ? fb.rtt_us : (7 * srtt_us_ + fb.rtt_us) / 8;
+        }
+        if (fb.lost_chunks > 0) {
+            if (fb.now_us >= recovery_end_us_) {
+                ssthresh_ = std::max<double>(cfg_.min_cwnd_chunks, cwnd_ * BETA);
+                cwnd_ = ssthresh_;
+                recovery_end_us_ = fb.now_us + recovery_us();
+            }
+        } else if (fb.acked_chunks > 0 && fb.now_us >= recovery_end_us_) {
+            if (cwnd_ < ssthresh_) {
+                cwnd_ += fb.acked_chunks;
+            } else {
+                cwnd_ += static_cast<double>(fb.acked_chunks) / cwnd_;
+            }
+        }
+        clamp();
+    }
+
+    void on_timeout(int64_t now_us) override {
+        if (now_us < recovery_end_us_) {
+            return;
+        }
+        ssthresh_ = std::max<double>(cfg_.min_cwnd_chunks, cwnd_ * BETA);
+        cwnd_ = cfg_.min_cwnd_chunks;
+        recovery_end_us_ = now_us + recovery_us();
+        clamp();
+    }
+
+    uint32_t cwnd_chunks() const override { return static_cast<uint32_t>(cwnd_); }
+
+    uint64_t pacing_rate() const override {
+        if (srtt_us_ == 0 || cfg_.chunk_bytes == 0) {
+            return cfg_.max_rate;
+        }
+        // Spread one window over an RTT, with headroom so pacing never limits growth
+        double gain = cwnd_ < ssthresh_ ? 2.0 : 1.25;
+        double rate = gain * cwnd_ * cfg_.chunk_bytes * 1e6 / srtt_us_;
+        uint64_t bytes_per_sec = static_cast<uint64_t>(std::min(rate, 1e15));
+        return cfg_.max_rate ? std::min(bytes_per_sec, cfg_.max_rate) : bytes_per_sec;
+    }
+
+private:
+    static constexpr double BETA = 0.5;
+
+    CCConfig cfg_;
+    double cwnd_;
+    double ssthresh_;
+    uint32_t srtt_us_;
+    int64_t recovery_end_us_;
+
+    int64_t recovery_us() const { return srtt_us_ ? static_cast<int64_t>(srtt_us_) : DEFAULT_RECOVERY_US; }
+
+    void clamp() {
+        cwnd_ = std::max<double>(cwnd_, cfg_.min_cwnd_chunks);
+        if (cfg_.max_cwnd_chunks) {
+            cwnd_ = std::min<double>(cwnd_, cfg_.max_cwnd_chunks);
+        }
+    }
+};
+
+// Delay-based, modelled on BBR: estimate bottleneck bandwidth (windowed max of
+// delivery rate) and propagation delay (windowed min RTT), pace at bw * gain and
+// cap the window at a multiple of the BDP. Feedback arrives once per receiver
+// control interval rather than per packet, so that interval is added to the RTT
+// when sizing the window, and rounds are counted in feedback messages.
+class DelayController : public CongestionController {
+public:
+    explicit DelayController(const CCConfig& cfg)
+        : cfg_(cfg), mode_(Mode::STARTUP), bw_samples_{}, round_(0), min_rtt_us_(0), min_rtt_stamp_us_(0),
+          last_feedback_us_(0), ack_interval_us_(0), full_bw_(0), full_bw_rounds_(0),
+          cycle_idx_(0), cycle_start_us_(0), conservative_(false) {}
+
+    CCAlgorithm algorithm() const override { return CCAlgorithm::DELAY; }
+
+    void on_feedback(const CCFeedback& fb) override {
+        if (last_feedback_us_ != 0) {
+            int64_t interval = fb.now_us - last_feedback_us_;
+            if (interval > 0) {
+                ack_interval_us_ = ack_interval_us_ == 0 ? interval : (3 * ack_interval_us_ + interval) / 4;
+                if (fb.acked_chunks > 0) {
+                    double sample = static_cast<double>(fb.acked_chunks) * cfg_.chunk_bytes * 1e6 / interval;
+                    bw_samples_[round_ % BW_WINDOW_ROUNDS] = static_cast<uint64_t>(sample);
+                    round_++;
+                }
+            }
+        }
+        last_feedback_us_ = fb.now_us;
+        conservative_ = false;
+
+        if (fb.rtt_us > 0 &&
+            (min_rtt_us_ == 0 || fb.rtt_us <= min_rtt_us_ || fb.now_us - min_rtt_stamp_us_ > MIN_RTT_WINDOW_US)) {
+            min_rtt_us_ = fb.rtt_us;
+            min_rtt_stamp_us_ = fb.now_us;
+        }
+
+        uint64_t bw = max_bw();
+        switch (mode_) {
+        case Mode::STARTUP:
+            if (fb.acked_chunks == 0) {
+                break;
+            }
+            // The pipe is full once the bandwidth estimate stops growing by 25% per round
+            if (bw >= full_bw_ + full_bw_ / 4) {
+                full_bw_ = bw;
+                full_bw_rounds_ = 0;
+            } else if (++full_bw_rounds_ >= 3 || fb.lost_chunks > 0) {
+                mode_ = Mode::DRAIN;
+            }
+            break;
+        case Mode::DRAIN:
+            if (static_cast<double>(fb.inflight_chunks) * cfg_.chunk_bytes <= bdp_bytes()) {
+                mode_ = Mode::PROBE_BW;
+                cycle_idx_ = 0;
+                cycle_start_us_ = fb.now_us;
+            }
+            break;
+        case Mode::PROBE_BW:
+            if (fb.now_us - cycle_start_us_ > std::max<int64_t>(min_rtt_us_, ack_interval_us_)) {
+                cycle_idx_ = (cycle_idx_ + 1) % PROBE_CYCLE;
+                cycle_start_us_ = fb.now_us;
+            }
+            break;
+        }
+    }
+
+    void on_timeout(int64_t) override {
+        // Keep the model, but hold the window at the floor until feedback resumes
+        conservative_ = true;
+    }
+
+    uint32_t cwnd_chunks() const override {
+        uint32_t cwnd = cfg_.initial_cwnd_chunks;
+        if (conservative_) {
+            cwnd = cfg_.min_cwnd_chunks;
+        } else if (max_bw() > 0 && cfg_.chunk_bytes > 0) {
+            double target = CWND_GAIN * bdp_bytes() / cfg_.chunk_bytes;
+            cwnd = static_cast<uint32_t>(std::min(std::ceil(target), 1e9));
+            if (mode_ == Mode::STARTUP) {
+                cwnd = std::max(cwnd, cfg_.initial_cwnd_chunks);
+            }
+        }
+        cwnd = std::max(cwnd, cfg_.min_cwnd_chunks);
+        return cfg_.max_cwnd_chunks ? std::min(cwnd, cfg_.max_cwnd_chunks) : cwnd;
+    }
+
+    uint64_t pacing_rate() const override {
+        uint64_t bw = max_bw();
+        if (bw == 0) {
+            return cfg_.max_rate;
+        }
+        double gain = mode_ == Mode::STARTUP ? STARTUP_GAIN
+                    : mode_ == Mode::DRAIN   ? 1.0 / STARTUP_GAIN
+                                             : PROBE_GAINS[cycle_idx_];
+        uint64_t rate = static_cast<uint64_t>(gain * bw);
+        return cfg_.max_rate ? std::min(rate, cfg_.max_rate) : rate;
+    }
+
+private:
+    enum class Mode : uint8_t { STARTUP, DRAIN, PROBE_BW };
+
+    static constexpr uint32_t BW_WINDOW_ROUNDS = 10;
+    static constexpr int64_t MIN_RTT_WINDOW_US = 10 * 1000000LL;
+    static constexpr double STARTUP_GAIN = 2.885;   // 2/ln(2): doubles delivery rate per round
+    static constexpr double CWND_GAIN = 2.0;
+    static constexpr uint32_t PROBE_CYCLE = 8;
+    static constexpr double PROBE_GAINS[PROBE_CYCLE] = {1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+
+    CCConfig cfg_;
+    Mode mode_;
+    uint64_t bw_samples_[BW_WINDOW_ROUNDS];   // Delivery rate (bytes/s) of the last rounds
+    uint64_t round_;
+    uint32_t min_rtt_us_;
+    int64_t min_rtt_stamp_us_;
+    int64_t last_feedback_us_;
+    int64_t ack_interval_us_;
+    uint64_t full_bw_;
+    uint32_t full_bw_rounds_;
+    uint32_t cycle_idx_;
+    int64_t cycle_start_us_;
+    bool conservative_;
+
+    uint64_t max_bw() const {
+        return *std::max_element(bw_samples_, bw_samples_ + BW_WINDOW_ROUNDS);
+    }
+
+    double bdp_bytes() const {
+        return static_cast<double>(max_bw()) * (min_rtt_us_ + ack_interval_us_) / 1e6;
+    }
+};
+
+} // namespace
+
+const char* cc_algorithm_name(CCAlgorithm algo) {
+    switch (algo) {
+    case CCAlgorithm::NONE: return "none";
+    case CCAlgorithm::AIMD: return "aimd";
+    case CCAlgorithm::DELAY: return "delay";
+    }
+    return "unknown";
+}
+
+std::unique_ptr<CongestionController> make_congestion_controller(CCAlgorithm algo, const CCConfig& cfg) {
+    switch (algo) {
+    case CCAlgorithm::AIMD:
+        return std::make_unique<AimdController>(cfg);
+    case CCAlgorithm::DELAY:
+        return std::make_unique<DelayController>(cfg);
+    case CCAlgorithm::NONE:
+        break;
+    }
+    return nullptr;
+}
+
+} // namespace sdr::reliability
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace sdr::reliability {
+
+// Congestion control policies for the SR sender
+enum class CCAlgorithm : uint8_t {
+    NONE = 0,   // Fixed window (max_inflight_chunks), pacing left to the connection
+    AIMD = 1,   // Loss-based: slow start, +1 chunk per window, halve on loss
+    DELAY = 2,  // Delay-based (BBR-like): pace at the measured bottleneck rate
+};
+
+const char* cc_algorithm_name(CCAlgorithm algo);
+
+struct CCConfig {
+    uint32_t chunk_bytes{0};
+    uint32_t initial_cwnd_chunks{10};
+    uint32_t min_cwnd_chunks{2};
+    uint32_t max_cwnd_chunks{0};   // 0 = unbounded
+    uint64_t max_rate{0};          // Pacing ceiling in bytes/s (0 = none)
+};
+
+// One SR_ACK/SR_NACK worth of feedback, digested by the sender
+struct CCFeedback {
+    int64_t now_us{0};
+    uint32_t acked_chunks{0};      // Newly acknowledged by this message
+    uint32_t inflight_chunks{0};   // Sent but unacknowledged before this message
+    uint32_t lost_chunks{0};       // Chunks this message caused to be retransmitted
+    uint32_t rtt_us{0};            // RTT sample, 0 if none was valid (Karn's rule)
+    uint32_t ack_delay_us{0};      // Receiver hold time already subtracted from rtt_us
+};
+
+// Window and pacing policy driven by receiver feedback. The sender keeps at most
+// cwnd_chunks() past the cumulative ACK and paces the data path at pacing_rate().
+class CongestionController {
+public:
+    virtual ~CongestionController() = default;
+
+    virtual CCAlgorithm algorithm() const = 0;
+    virtual void on_feedback(const CCFeedback& fb) = 0;
+    virtual void on_timeout(int64_t now_us) = 0;
+
+    virtual uint32_t cwnd_chunks() const = 0;
+    virtual uint64_t pacing_rate() const = 0;   // bytes/s, 0 = unpaced
+};
+
+// Returns nullptr for CCAlgorithm::NONE
+std::unique_ptr<CongestionController> make_congestion_controller(CCAlgorithm algo, const CCConfig& cfg);
+
+} // namespace sdr::reliability
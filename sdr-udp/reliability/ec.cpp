@@ -3,6 +3,7 @@
 #include <cstring>
 #include <algorithm>
 #include "reliability/sr.h"
+#include "sdr_bitmap_kernels.h"
 
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -85,7 +86,7 @@ int ECSender::encode_and_send(SDRConnection* conn, const void* buffer, size_t le
 }
 
 int ECSender::poll() {
-    if (sends_.empty() || !conn_ || !conn_->tcp_client) {
+    if (sends_.empty() || !conn_ || !conn_->tcp_client || !conn_->udp_sender) {
         return -1;
     }
     auto* handle = sends_.front().get();
@@ -97,64 +98,34 @@ int ECSender::poll() {
     uint32_t data_chunks = static_cast<uint32_t>((cfg_.data_bytes + chunk_bytes - 1) / chunk_bytes);
 
     auto retransmit_chunk = [&](uint32_t chunk_id) {
-        int udp_socket = socket(AF_INET, SOCK_DGRAM, 0);
-        if (udp_socket < 0) return;
-        struct sockaddr_in server_addr;
-        std::memset(&server_addr, 0, sizeof(server_addr));
-        server_addr.sin_family = AF_INET;
-        server_addr.sin_port = htons(params.udp_server_port);
-        inet_pton(AF_INET, params.udp_server_ip, &server_addr.sin_addr);
-
-        const uint8_t* data = static_cast<const uint8_t*>(handle->user_buffer);
+        UDPSender& sender = *conn_->udp_sender;
+        sender.builder().set_message(params.transfer_id, handle->msg_id, ppc, mtu,
+                                     handle->user_buffer, handle->buffer_size,
+                                     conn_->connection_ctx->get_connection_id(),
+                                     conn_->connection_ctx->header_format(),
+                                     conn_->connection_ctx->payload_crc());
         std::cout << "[EC][Sender] Retransmitting chunk " << chunk_id << " (" << ppc << " packets)\n";
-        for (uint16_t pkt = 0; pkt < ppc; ++pkt) {
-            uint32_t packet_offset = chunk_id * ppc + pkt;
-            size_t data_offset = static_cast<size_t>(packet_offset) * mtu;
-            if (data_offset >= handle->buffer_size) break;
-            size_t remaining = handle->buffer_size - data_offset;
-            size_t pkt_len = std::min(static_cast<size_t>(mtu), remaining);
-            SDRPacket* packet = SDRPacket::create_data_packet(
-                params.transfer_id, handle->msg_id, packet_offset, ppc,
-                data + data_offset, pkt_len);
-            if (!packet) break;
-            packet->header.chunk_seq = packet->header.get_chunk_id();
-            size_t total_sz = sizeof(SDRPacketHeader) + pkt_len;
-            packet->header.to_network_order();
-            sendto(udp_socket, packet, total_sz, 0,
-                   (struct sockaddr*)&server_addr, sizeof(server_addr));
-            SDRPacket::destroy(packet);
-        }
-        close(udp_socket);
+        stats_.packets_retransmitted += sender.send_range(chunk_id * ppc, ppc);
+    };
+
+    auto bitmap_chunks = [&](const ControlMessage& msg) {
+        return std::min<uint32_t>(std::min<uint16_t>(msg.chunk_bitmap_words, 16) * 64, data_chunks);
     };
 
     auto apply_bitmap = [&](const ControlMessage& msg) {
-        uint32_t words = msg.chunk_bitmap_words;
-        uint32_t max_chunks = data_chunks;
-        for (uint32_t w = 0; w < words && w < 16; ++w) {
-            uint64_t word = msg.chunk_bitmap[w];
-            for (uint32_t bit = 0; bit < 64; ++bit) {
-                uint32_t chunk_id = w * 64 + bit;
-                if (chunk_id >= max_chunks) break;
-                if (word & (1ULL << bit)) {
-                    chunk_acked_[chunk_id] = true;
-                }
-            }
-        }
+        bitmap::for_each_set_bit(msg.chunk_bitmap, bitmap_chunks(msg), [&](uint32_t chunk_id) {
+            chunk_acked_[chunk_id] = true;
+        });
     };
 
     auto retransmit_missing_bitmap = [&](const ControlMessage& msg, uint32_t limit) {
         uint32_t sent = 0;
-        uint32_t words = msg.chunk_bitmap_words;
-        for (uint32_t w = 0; w < words && sent < limit && w < 16; ++w) {
-            uint64_t word = msg.chunk_bitmap[w];
-            for (uint32_t bit = 0; bit < 64 && sent < limit; ++bit) {
-                uint32_t chunk_id = w * 64 + bit;
-                if (chunk_id >= data_chunks) break;
-                if ((word & (1ULL << bit)) == 0) {
-                    retransmit_chunk(chunk_id);
-                    sent++;
-                }
-            }
+        uint32_t nbits = bitmap_chunks(msg);
+        for (uint32_t chunk_id = bitmap::find_first_zero(msg.chunk_bitmap, nbits);
+             chunk_id < nbits && sent < limit;
+             chunk_id = bitmap::find_first_zero(msg.chunk_bitmap, nbits, chunk_id + 1)) {
+            retransmit_chunk(chunk_id);
+            sent++;
         }
     };
 
@@ -162,8 +133,6 @@ int ECSender::poll() {
         ControlMessage msg;
         if (!conn_->tcp_client->receive_message(msg)) {
             // Timeout, keep waiting as long as the TCP connection is alive
-            int rc = sdr_send_poll(handle);
-            if (rc == 0) return 0;
             if (!conn_->tcp_client->is_connected()) {
                 std::cerr << "[EC][Sender] Control connection closed while waiting for ACK\n";
                 return -1;
@@ -172,6 +141,9 @@ int ECSender::poll() {
         }
         if (msg.msg_type == ControlMsgType::EC_ACK || msg.msg_type == ControlMsgType::COMPLETE_ACK) {
             return 0;
+        } else if (msg.msg_type == ControlMsgType::INCOMPLETE_NACK) {
+            std::cerr << "[EC][Sender] Receiver reported the transfer incomplete\n";
+            return -1;
         } else if (msg.msg_type == ControlMsgType::EC_NACK ||
                    msg.msg_type == ControlMsgType::EC_FALLBACK_SR ||
                    msg.msg_type == ControlMsgType::SR_NACK ||
@@ -246,20 +218,18 @@ bool ECReceiver::try_decode() {
     auto* ctx = recv_handle_->msg_ctx.get();
     if (!ctx || !ctx->frontend_bitmap) return false;
 
-    // Count missing data chunks
-    std::vector<uint32_t> missing_data;
-    for (uint32_t c = 0; c < data_chunks_; ++c) {
-        if (!ctx->frontend_bitmap->is_chunk_complete(c)) {
-            missing_data.push_back(c);
-        }
-    }
+    // Snapshot the chunk bitmap once; gaps and counts come from the bitmap kernels
+    const uint32_t total_chunks = data_chunks_ + parity_chunks_;
+    std::vector<uint64_t> words((total_chunks + 63) / 64, 0);
+    ctx->frontend_bitmap->snapshot_chunk_bitmap(words.data(), static_cast<uint32_t>(words.size()));
+    const uint32_t missing_data = data_chunks_ - bitmap::popcount(words.data(), data_chunks_);
 
     // Fallback SR control path (best-effort) if already active
     if (fallback_active_) {
-        if (missing_data.empty()) {
+        if (missing_data == 0) {
             stats_.decode_success++;
             ctx->total_chunks = data_chunks_;
-            ctx->state = MessageState::COMPLETED;
+            ctx->close(MessageState::COMPLETED);
             if (conn_ && conn_->tcp_server) {
                 ControlMessage msg{};
                 msg.magic = ControlMessage::MAGIC_VALUE;
@@ -275,10 +245,10 @@ bool ECReceiver::try_decode() {
     }
 
     // All data present without decode
-    if (missing_data.empty()) {
+    if (missing_data == 0) {
         stats_.decode_success++;
         ctx->total_chunks = data_chunks_;
-        ctx->state = MessageState::COMPLETED;
+        ctx->close(MessageState::COMPLETED);
         if (conn_ && conn_->tcp_server) {
             ControlMessage msg{};
             msg.magic = ControlMessage::MAGIC_VALUE;
@@ -290,26 +260,19 @@ bool ECReceiver::try_decode() {
     }
 
     // Too many losses -> request retransmit or fallback to SR
-    if (missing_data.size() > m_) {
+    if (missing_data > m_) {
         if (conn_ && conn_->tcp_server) {
             ControlMessage msg{};
             msg.magic = ControlMessage::MAGIC_VALUE;
             msg.connection_id = conn_->connection_ctx->get_connection_id();
-            msg.num_gaps = 0;
-            // collapse missing_data into gaps
-            size_t idx = 0;
-            while (idx < missing_data.size() && msg.num_gaps < 16) {
-                uint32_t start = missing_data[idx];
-                uint32_t lenrun = 1;
-                idx++;
-                while (idx < missing_data.size() && missing_data[idx] == start + lenrun) {
-                    lenrun++;
-                    idx++;
-                }
-                msg.gap_start[msg.num_gaps] = static_cast<uint16_t>(start);
-                msg.gap_len[msg.num_gaps] = static_cast<uint16_t>(lenrun);
-                msg.num_gaps++;
+            // collapse missing data chunks into gaps
+            bitmap::Gap gaps[16];
+            size_t gap_count = bitmap::extract_gaps(words.data(), data_chunks_, gaps, 16);
+            for (size_t i = 0; i < gap_count; ++i) {
+                msg.gap_start[i] = gaps[i].start;
+                msg.gap_len[i] = gaps[i].len;
             }
+            msg.num_gaps = static_cast<uint16_t>(gap_count);
             if (decode_attempts_ + 1 >= cfg_.max_retries) {
                 msg.msg_type = ControlMsgType::EC_FALLBACK_SR;
                 fallback_active_ = true;
@@ -328,11 +291,9 @@ bool ECReceiver::try_decode() {
 #ifdef HAS_ISAL
     // Build lists of available chunks (data+parity)
     std::vector<uint32_t> avail_idxs;
-    for (uint32_t c = 0; c < data_chunks_ + parity_chunks_; ++c) {
-        if (ctx->frontend_bitmap->is_chunk_complete(c)) {
-            avail_idxs.push_back(c);
-        }
-    }
+    bitmap::for_each_set_bit(words.data(), total_chunks, [&](uint32_t c) {
+        avail_idxs.push_back(c);
+    });
     if (avail_idxs.size() < k_) {
         stats_.fallback_sr++;
         return false;
@@ -360,8 +321,8 @@ bool ECReceiver::try_decode() {
     }
 
     // Recover missing data chunks
-    for (size_t mi = 0; mi < missing_data.size(); ++mi) {
-        uint32_t idx = missing_data[mi];
+    uint32_t idx = bitmap::find_first_zero(words.data(), data_chunks_);
+    for (size_t mi = 0; mi < missing_data; ++mi, idx = bitmap::find_first_zero(words.data(), data_chunks_, idx + 1)) {
         recover_ptrs[mi] = static_cast<uint8_t*>(ctx->buffer) + idx * chunk_bytes_;
         ec_init_tables(k_, 1, decode_matrix.data() + mi * k_, gftbl.data());
         ec_encode_data(chunk_bytes_, k_, 1, gftbl.data(), src_ptrs.data(), &recover_ptrs[mi]);
@@ -369,7 +330,7 @@ bool ECReceiver::try_decode() {
     stats_.decode_success++;
     if (ctx) {
         ctx->total_chunks = data_chunks_;
-        ctx->state = MessageState::COMPLETED;
+        ctx->close(MessageState::COMPLETED);
     }
     if (conn_ && conn_->tcp_server) {
         ControlMessage msg{};
@@ -20,6 +20,7 @@ struct ECStats {
     uint64_t parity_sent{0};
     uint64_t decode_success{0};
     uint64_t fallback_sr{0};
+    uint64_t packets_retransmitted{0};   // Data packets re-sent after EC_FALLBACK_SR/EC_NACK
 };
 
 class ECSender {
@@ -0,0 +1,51 @@
+#include "reliability/rtt_estimator.h"
+#include <algorithm>
+
+namespace sdr::reliability {
+
+RttEstimator::RttEstimator(const Config& cfg)
+    : cfg_(cfg), srtt_us_(0), rttvar_us_(0), max_ack_delay_us_(0), backoff_(0) {
+    cfg_.min_rto_us = std::max<uint32_t>(cfg_.min_rto_us, 1);
+    cfg_.max_rto_us = std::max(cfg_.max_rto_us, cfg_.min_rto_us);
+}
+
+void RttEstimator::on_sample(uint32_t rtt_us, uint32_t ack_delay_us) {
+    rtt_us = std::max<uint32_t>(rtt_us, 1);
+    if (srtt_us_ == 0) {
+        // RFC 6298 (2.2): first measurement
+        srtt_us_ = rtt_us;
+        rttvar_us_ = rtt_us / 2;
+    } else {
+        // RFC 6298 (2.3): RTTVAR before SRTT, using the old SRTT
+        uint32_t err = srtt_us_ > rtt_us ? srtt_us_ - rtt_us : rtt_us - srtt_us_;
+        rttvar_us_ = static_cast<uint32_t>((3ULL * rttvar_us_ + err) / 4);
+        srtt_us_ = static_cast<uint32_t>((7ULL * srtt_us_ + rtt_us) / 8);
+    }
+    max_ack_delay_us_ = std::max(max_ack_delay_us_, std::min(ack_delay_us, cfg_.max_rto_us));
+    // A valid sample ends backoff (RFC 6298 5.7 with Karn's rule)
+    backoff_ = 0;
+}
+
+void RttEstimator::on_timeout() {
+    // RFC 6298 (5.5)
+    if (backoff_ < MAX_BACKOFF) {
+        backoff_++;
+    }
+}
+
+uint32_t RttEstimator::in_flight_us() const {
+    if (srtt_us_ == 0) {
+        return cfg_.initial_rto_us;
+    }
+    uint64_t span = static_cast<uint64_t>(srtt_us_) + std::max<uint64_t>(cfg_.granularity_us, 4ULL * rttvar_us_);
+    return static_cast<uint32_t>(std::min<uint64_t>(span, cfg_.max_rto_us));
+}
+
+uint32_t RttEstimator::rto_us() const {
+    uint64_t rto = srtt_us_ == 0 ? cfg_.initial_rto_us
+                                 : static_cast<uint64_t>(in_flight_us()) + max_ack_delay_us_;
+    rto <<= backoff_;
+    return static_cast<uint32_t>(std::clamp<uint64_t>(rto, cfg_.min_rto_us, cfg_.max_rto_us));
+}
+
+} // namespace sdr::reliability
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+namespace sdr::reliability {
+
+// Retransmission timeout from RTT samples, after RFC 6298: SRTT/RTTVAR with
+// alpha = 1/8, beta = 1/4, RTO = SRTT + max(G, 4 * RTTVAR), doubled per
+// expiry until the next valid sample. SR feedback is sent once per receiver
+// control tick, so the largest acknowledgement delay the receiver reported is
+// added to the RTO (as in QUIC's PTO); otherwise chunks would time out before
+// their ACK could possibly arrive.
+class RttEstimator {
+public:
+    struct Config {
+        uint32_t initial_rto_us{200000};
+        uint32_t min_rto_us{1000};
+        uint32_t max_rto_us{10000000};
+        uint32_t granularity_us{1000};   // G: clock granularity term
+    };
+
+    explicit RttEstimator(const Config& cfg);
+
+    // Sample from a once-transmitted chunk (Karn); ack_delay_us is the receiver's hold time
+    void on_sample(uint32_t rtt_us, uint32_t ack_delay_us);
+    // A retransmission timer expired: back off
+    void on_timeout();
+
+    bool has_sample() const { return srtt_us_ != 0; }
+    uint32_t srtt_us() const { return srtt_us_; }
+    uint32_t rttvar_us() const { return rttvar_us_; }
+    uint32_t backoff() const { return backoff_; }
+
+    // Current timeout including backoff
+    uint32_t rto_us() const;
+    // How long a sent chunk may legitimately still be in flight: SRTT + max(G, 4 * RTTVAR),
+    // without backoff or ACK delay. Before the first sample, the initial RTO.
+    uint32_t in_flight_us() const;
+
+private:
+    static constexpr uint32_t MAX_BACKOFF = 6;
+
+    Config cfg_;
+    uint32_t srtt_us_;
+    uint32_t rttvar_us_;
+    uint32_t max_ack_delay_us_;
+    uint32_t backoff_;
+};
+
+} // namespace sdr::reliability
@@ -1,4 +1,5 @@
 #include "reliability/sr.h"
+#include "sdr_bitmap_kernels.h"
 #include <iostream>
 #include <arpa/inet.h>
 #include <netinet/in.h>
@@ -9,47 +10,48 @@
 
 namespace sdr::reliability {
 
-void SRSender::send_packets_range(uint32_t start_packet, uint32_t packet_count) {
-    if (!conn_ || !send_handle_) return;
-    const ConnectionParams& params = conn_->connection_ctx->get_params();
-    int udp_socket = socket(AF_INET, SOCK_DGRAM, 0);
-    if (udp_socket < 0) {
-        std::cerr << "[SR][Sender] Failed to create UDP socket for retransmit: " << strerror(errno) << "\n";
-        return;
-    }
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(params.udp_server_port);
-    if (inet_pton(AF_INET, params.udp_server_ip, &server_addr.sin_addr) <= 0) {
-        std::cerr << "[SR][Sender] Invalid server IP for retransmit: " << params.udp_server_ip << "\n";
-        close(udp_socket);
-        return;
+namespace {
+
+// Chunk bitmap words one feedback message carries (ControlMessage::chunk_bitmap)
+constexpr uint32_t BITMAP_WINDOW_WORDS = 16;
+
+} // namespace
+
+void SRHistogram::record(uint32_t us) {
+    size_t bucket = 0;
+    while (bucket + 1 < BUCKETS && (us >> (bucket + 1)) != 0) {
+        bucket++;
     }
+    counts[bucket]++;
+    total++;
+}
 
-    const uint8_t* data = static_cast<const uint8_t*>(send_handle_->user_buffer);
-    for (uint32_t i = 0; i < packet_count; ++i) {
-        uint32_t packet_offset = start_packet + i;
-        size_t data_offset = static_cast<size_t>(packet_offset) * mtu_bytes_;
-        if (data_offset >= send_handle_->buffer_size) break;
-        size_t remaining = send_handle_->buffer_size - data_offset;
-        size_t packet_data_len = std::min(static_cast<size_t>(mtu_bytes_), remaining);
-        if (packet_data_len > SDRPacket::MAX_PAYLOAD_SIZE) {
-            packet_data_len = SDRPacket::MAX_PAYLOAD_SIZE;
+uint32_t SRHistogram::percentile_us(double p) const {
+    if (total == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * total + 0.5);
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return i + 1 < BUCKETS ? bucket_floor_us(i + 1) : UINT32_MAX;
         }
-
-        SDRPacket* packet = SDRPacket::create_data_packet(
-            params.transfer_id, send_handle_->msg_id, packet_offset,
-            packets_per_chunk_, data + data_offset, packet_data_len);
-        if (!packet) continue;
-        packet->header.chunk_seq = packet->header.get_chunk_id();
-        size_t total_packet_size = sizeof(SDRPacketHeader) + packet_data_len;
-        packet->header.to_network_order();
-        sendto(udp_socket, packet, total_packet_size, 0,
-               (struct sockaddr*)&server_addr, sizeof(server_addr));
-        SDRPacket::destroy(packet);
     }
-    close(udp_socket);
+    return UINT32_MAX;
+}
+
+size_t SRSender::send_packets_range(uint32_t start_packet, uint32_t packet_count) {
+    if (!conn_ || !send_handle_ || !conn_->udp_sender) return 0;
+    const ConnectionParams& params = conn_->connection_ctx->get_params();
+
+    // Channel sockets and batch size were set up by sdr_send_post for this connection
+    UDPSender& sender = *conn_->udp_sender;
+    sender.builder().set_message(params.transfer_id, send_handle_->msg_id, packets_per_chunk_,
+                                 mtu_bytes_, send_handle_->user_buffer, send_handle_->buffer_size,
+                                 conn_->connection_ctx->get_connection_id(),
+                                 conn_->connection_ctx->header_format(),
+                                 conn_->connection_ctx->payload_crc());
+    return sender.send_range(start_packet, packet_count);
 }
 
 void SRSender::retransmit_range(uint32_t start_chunk, uint32_t count) {
@@ -65,11 +67,64 @@ void SRSender::retransmit_range(uint32_t start_chunk, uint32_t count) {
     std::cout << "[SR][Sender] Retransmitting chunk " << start_chunk
               << " (" << packet_count << " packets: " << start_packet
               << " .. " << (start_packet + (packet_count ? packet_count - 1 : 0)) << ")\n";
-    send_packets_range(start_packet, packet_count);
+    // The initial window goes out through here too; only first sends count as packets_sent
+    size_t sent = send_packets_range(start_packet, packet_count);
+    if (tx_count_[start_chunk] == 0) {
+        send_handle_->packets_sent += sent;
+    } else {
+        stats_.packets_retransmitted += sent;
+    }
     stats_.retransmits += count;
     auto now = std::chrono::steady_clock::now();
     for (uint32_t c = start_chunk; c < start_chunk + count && c < total_chunks_; ++c) {
         last_tx_[c] = now;
+        if (tx_count_[c] < UINT8_MAX) tx_count_[c]++;
+    }
+}
+
+uint32_t SRSender::send_window() const {
+    uint32_t window = max_inflight_;
+    if (cc_) {
+        window = std::min<uint32_t>(window, std::max<uint32_t>(1, cc_->cwnd_chunks()));
+    }
+    return window;
+}
+
+void SRSender::apply_congestion_control(const CCFeedback& fb) {
+    if (fb.rtt_us > 0) {
+        rtt_.on_sample(fb.rtt_us, fb.ack_delay_us);
+        stats_.rtt_samples++;
+        stats_.last_rtt_us = fb.rtt_us;
+        stats_.min_rtt_us = stats_.min_rtt_us ? std::min(stats_.min_rtt_us, fb.rtt_us) : fb.rtt_us;
+        stats_.rtt_hist.record(fb.rtt_us);
+        record_rto();
+    }
+    if (cc_) {
+        cc_->on_feedback(fb);
+        sync_pacing_rate();
+    }
+    stats_.cwnd_chunks = send_window();
+    stats_.pacing_rate = conn_->pacer ? conn_->pacer->rate() : 0;
+    if (stats_.cc_trace.size() < SRStats::MAX_CC_TRACE) {
+        auto since_start = std::chrono::steady_clock::now() - start_time_;
+        stats_.cc_trace.push_back(SRCCSample{
+            static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(since_start).count()),
+            fb.rtt_us, stats_.cwnd_chunks, stats_.pacing_rate});
+    }
+}
+
+void SRSender::record_rto() {
+    stats_.srtt_us = rtt_.srtt_us();
+    stats_.rttvar_us = rtt_.rttvar_us();
+    stats_.rto_us = rtt_.rto_us();
+    stats_.rto_hist.record(stats_.rto_us);
+}
+
+void SRSender::sync_pacing_rate() {
+    if (!cc_ || !conn_->pacer) return;
+    uint64_t rate = cc_->pacing_rate();
+    if (rate != conn_->pacer->rate()) {
+        conn_->pacer->set_rate(rate, conn_->pacer->burst_bytes());
     }
 }
 
@@ -93,14 +148,38 @@ int SRSender::start_send(SDRConnection* conn, const void* buffer, size_t length)
     uint64_t chunk_bytes = static_cast<uint64_t>(mtu_bytes_) * packets_per_chunk_;
     total_chunks_ = static_cast<uint32_t>((length + chunk_bytes - 1) / chunk_bytes);
     chunk_acked_.assign(total_chunks_, false);
+    tx_count_.assign(total_chunks_, 0);
     last_tx_.assign(total_chunks_, std::chrono::steady_clock::now());
     last_control_tx_ = std::chrono::steady_clock::now();
+    start_time_ = last_control_tx_;
+
+    RttEstimator::Config rtt_cfg;
+    rtt_cfg.initial_rto_us = (cfg_.rto_ms ? cfg_.rto_ms : (cfg_.base_rtt_ms + cfg_.alpha_ms)) * 1000;
+    rtt_cfg.min_rto_us = cfg_.min_rto_ms * 1000;
+    rtt_cfg.max_rto_us = cfg_.max_rto_ms * 1000;
+    rtt_ = RttEstimator(rtt_cfg);
+    stats_.rto_us = rtt_.rto_us();
 
     ack_base_ = 0;
     next_chunk_to_send_ = 0;
-    max_inflight_ = cfg_.max_inflight_chunks ? cfg_.max_inflight_chunks : static_cast<uint16_t>(total_chunks_);
-    if (max_inflight_ == 0) max_inflight_ = static_cast<uint16_t>(total_chunks_);
-    uint32_t initial_limit = std::min<uint32_t>(total_chunks_, max_inflight_);
+    max_inflight_ = cfg_.max_inflight_chunks ? cfg_.max_inflight_chunks : total_chunks_;
+
+    cc_.reset();
+    if (cfg_.cc != CCAlgorithm::NONE) {
+        CCConfig cc_cfg;
+        cc_cfg.chunk_bytes = static_cast<uint32_t>(chunk_bytes);
+        if (cfg_.initial_cwnd_chunks) cc_cfg.initial_cwnd_chunks = cfg_.initial_cwnd_chunks;
+        cc_cfg.max_cwnd_chunks = cfg_.max_inflight_chunks;
+        // The negotiated connection pacing rate stays a ceiling for the controller
+        cc_cfg.max_rate = conn_->pacer ? conn_->pacer->rate() : 0;
+        cc_ = make_congestion_controller(cfg_.cc, cc_cfg);
+        std::cout << "[SR][Sender] Congestion control: " << cc_algorithm_name(cfg_.cc)
+                  << ", initial window " << send_window() << " chunks" << std::endl;
+    }
+    stats_.cwnd_chunks = send_window();
+    stats_.pacing_rate = conn_->pacer ? conn_->pacer->rate() : 0;
+
+    uint32_t initial_limit = std::min<uint32_t>(total_chunks_, send_window());
     for (uint32_t c = 0; c < initial_limit; ++c) {
         retransmit_range(c, 1);
         next_chunk_to_send_ = c + 1;
@@ -113,128 +192,183 @@ int SRSender::poll() {
         return -1;
     }
 
-    auto* ctx = send_handle_->connection_ctx.get();
-    const ConnectionParams& params = ctx->get_params();
-    const uint32_t mtu = params.mtu_bytes;
-    const uint16_t ppc = params.packets_per_chunk;
-    const uint32_t effective_rto_ms = cfg_.rto_ms ? cfg_.rto_ms : (cfg_.base_rtt_ms + cfg_.alpha_ms);
-    const uint32_t guard_ms = 50; // suppress back-to-back retransmits
+    auto elapsed_us = [&](uint32_t c, std::chrono::steady_clock::time_point now) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(now - last_tx_[c]).count();
+    };
 
+    // Only chunks already sent are candidates; the window decides when new ones go out.
+    // A chunk reported missing within one RTT-derived span of its last send may still
+    // be in flight, so it is left alone.
     auto retransmit_missing_from_bitmap = [&](uint32_t limit) {
         uint32_t sent = 0;
         auto now = std::chrono::steady_clock::now();
-        for (uint32_t c = 0; c < total_chunks_ && sent < limit; ++c) {
+        const int64_t guard_us = rtt_.in_flight_us();
+        for (uint32_t c = 0; c < next_chunk_to_send_ && sent < limit; ++c) {
             if (chunk_acked_[c]) continue;
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_tx_[c]).count();
-            if (elapsed < static_cast<long>(guard_ms)) continue; // recently retransmitted
+            if (elapsed_us(c, now) < guard_us) continue; // recently (re)transmitted
             retransmit_range(c, 1);
             sent++;
         }
+        return sent;
     };
-    
-    // Helper to apply bitmap from control message
-    auto apply_bitmap = [&](const ControlMessage& msg) {
-        uint32_t words = msg.chunk_bitmap_words;
-        uint32_t max_chunks = total_chunks_;
-        for (uint32_t w = 0; w < words && w < 8; ++w) {
-            uint64_t word = msg.chunk_bitmap[w];
-            for (uint32_t bit = 0; bit < 64; ++bit) {
-                uint32_t chunk_id = w * 64 + bit;
-                if (chunk_id >= max_chunks) break;
-                if (word & (1ULL << bit)) {
-                    chunk_acked_[chunk_id] = true;
-                }
+
+    // One receiver tick is any SR_BITMAP fragments followed by its SR_ACK/SR_NACK;
+    // the tick's feedback and RTT candidate accumulate over all of them.
+    CCFeedback fb;
+    int64_t min_elapsed_us = -1;
+    bool tick_open = false;
+
+    // Apply a bitmap window and, on the tick's last message, the cumulative ACK.
+    // The RTT sample is taken from the most recently sent chunk the tick newly
+    // acknowledges, skipping retransmitted chunks (Karn), minus the receiver's
+    // reported hold time.
+    auto apply_feedback = [&](const ControlMessage& msg) {
+        auto now = std::chrono::steady_clock::now();
+        if (!tick_open) {
+            fb = CCFeedback{};
+            min_elapsed_us = -1;
+            for (uint32_t c = 0; c < next_chunk_to_send_; ++c) {
+                if (!chunk_acked_[c]) fb.inflight_chunks++;
             }
+            tick_open = true;
+        }
+        fb.now_us = std::chrono::duration_cast<std::chrono::microseconds>(now - start_time_).count();
+        auto mark_acked = [&](uint32_t c) {
+            if (chunk_acked_[c]) return;
+            chunk_acked_[c] = true;
+            fb.acked_chunks++;
+            if (tx_count_[c] == 1) {
+                int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(now - last_tx_[c]).count();
+                if (min_elapsed_us < 0 || us < min_elapsed_us) min_elapsed_us = us;
+            }
+        };
+
+        const uint32_t base = msg.bitmap_base;
+        if (base < total_chunks_) {
+            uint32_t bitmap_chunks = std::min<uint32_t>(std::min<uint32_t>(msg.chunk_bitmap_words, BITMAP_WINDOW_WORDS) * 64,
+                                                        total_chunks_ - base);
+            bitmap::for_each_set_bit(msg.chunk_bitmap, bitmap_chunks, [&](uint32_t bit) { mark_acked(base + bit); });
+        }
+        if (msg.msg_type == ControlMsgType::SR_BITMAP) {
+            return;
+        }
+        uint32_t prefix = std::min(msg.acked_prefix, total_chunks_);
+        for (uint32_t c = ack_base_; c < prefix; ++c) {
+            mark_acked(c);
+        }
+        ack_base_ = std::max(ack_base_, prefix);
+        fb.ack_delay_us = msg.ack_delay_us;
+        if (min_elapsed_us > static_cast<int64_t>(msg.ack_delay_us)) {
+            fb.rtt_us = static_cast<uint32_t>(std::min<int64_t>(min_elapsed_us - msg.ack_delay_us, UINT32_MAX));
+        }
+        tick_open = false;
+    };
+
+    auto advance_window = [&]() {
+        uint32_t window = send_window();
+        while (next_chunk_to_send_ < total_chunks_ &&
+               next_chunk_to_send_ < ack_base_ + window) {
+            if (!chunk_acked_[next_chunk_to_send_]) {
+                retransmit_range(next_chunk_to_send_, 1);
+            }
+            next_chunk_to_send_++;
         }
     };
 
-    // Simple control loop: process SR_ACK/SR_NACK until COMPLETE or error
+    // Retransmit chunks unacknowledged for a full RTO; one expiry backs the timer off
+    auto check_rto = [&]() {
+        auto now = std::chrono::steady_clock::now();
+        const int64_t rto_us = rtt_.rto_us();
+        bool timed_out = false;
+        for (uint32_t c = 0; c < next_chunk_to_send_; ++c) {
+            if (chunk_acked_[c]) continue;
+            if (elapsed_us(c, now) > rto_us) {
+                std::cout << "[SR][Sender] RTO retransmit chunk " << c
+                          << " (rto " << rto_us / 1000.0 << " ms)" << std::endl;
+                retransmit_range(c, 1);
+                timed_out = true;
+            }
+        }
+        if (timed_out) {
+            stats_.rto_timeouts++;
+            rtt_.on_timeout();
+            record_rto();
+            if (cc_) {
+                cc_->on_timeout(std::chrono::duration_cast<std::chrono::microseconds>(now - start_time_).count());
+                sync_pacing_rate();
+                stats_.cwnd_chunks = send_window();
+            }
+        }
+    };
+
+    // Time until the oldest unacknowledged chunk's RTO expires, in whole ms within [1, 200]
+    auto rto_wait = [&]() {
+        auto now = std::chrono::steady_clock::now();
+        const int64_t rto_us = rtt_.rto_us();
+        int64_t wait_us = 200000;
+        for (uint32_t c = 0; c < next_chunk_to_send_; ++c) {
+            if (chunk_acked_[c]) continue;
+            wait_us = std::min<int64_t>(wait_us, rto_us - elapsed_us(c, now));
+        }
+        return std::chrono::milliseconds(std::max<int64_t>(1, (wait_us + 999) / 1000));
+    };
+
+    // Simple control loop: process SR_ACK/SR_NACK until COMPLETE or error.
+    // The wait ends at the next RTO deadline so retransmits are not held back
+    // behind a fixed receive timeout.
     while (true) {
         ControlMessage msg;
-        if (!conn_->tcp_client->receive_message(msg)) {
-            // Timeout: poll completion and drive RTO-based retransmits
-            int rc = sdr_send_poll(send_handle_.get());
-            if (rc == 0) return 0;
-            auto now = std::chrono::steady_clock::now();
-            for (uint32_t c = 0; c < total_chunks_; ++c) {
-                if (chunk_acked_[c]) continue;
-                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_tx_[c]).count();
-                if (elapsed > static_cast<long>(effective_rto_ms)) {
-                    std::cout << "[SR][Sender] RTO retransmit chunk " << c << std::endl;
-                    retransmit_range(c, 1);
-                    last_tx_[c] = now;
-                }
+        if (!conn_->tcp_client->receive_message(msg, rto_wait())) {
+            if (!conn_->tcp_client->is_connected()) {
+                std::cerr << "[SR][Sender] Control connection closed" << std::endl;
+                return -1;
             }
+            check_rto();
             continue;
         }
 
-        if (msg.msg_type == ControlMsgType::SR_ACK) {
-            uint32_t cum_chunk = msg.params.max_inflight; // reused field
-            std::cout << "[SR][Sender] Received SR_ACK cum=" << cum_chunk
-                      << " total=" << msg.params.total_chunks << std::endl;
-            apply_bitmap(msg);
-            if (cum_chunk != UINT32_MAX && cum_chunk + 1 > ack_base_) {
-                ack_base_ = cum_chunk + 1;
-            }
-            if (cum_chunk != UINT32_MAX) {
-                for (uint32_t c = 0; c <= cum_chunk && c < total_chunks_; ++c) {
-                    chunk_acked_[c] = true;
-                }
-            }
+        if (msg.msg_type == ControlMsgType::SR_BITMAP) {
+            apply_feedback(msg);
+        } else if (msg.msg_type == ControlMsgType::SR_ACK) {
+            std::cout << "[SR][Sender] Received SR_ACK prefix=" << msg.acked_prefix
+                      << " total=" << msg.total_chunks << std::endl;
+            apply_feedback(msg);
             stats_.acks_sent++;
-            retransmit_missing_from_bitmap(4); // send a few missing chunks per control tick
-            while (next_chunk_to_send_ < total_chunks_ &&
-                   next_chunk_to_send_ < ack_base_ + max_inflight_) {
-                if (!chunk_acked_[next_chunk_to_send_]) {
-                    retransmit_range(next_chunk_to_send_, 1);
-                }
-                next_chunk_to_send_++;
-            }
-            if (cum_chunk + 1 >= msg.params.total_chunks) {
+            fb.lost_chunks = retransmit_missing_from_bitmap(4); // send a few missing chunks per control tick
+            apply_congestion_control(fb);
+            advance_window();
+            if (msg.acked_prefix >= msg.total_chunks) {
                 return 0;
             }
-            // keep waiting
+            // Feedback arrives every receiver control tick, which also clocks the RTO check
+            check_rto();
         } else if (msg.msg_type == ControlMsgType::SR_NACK) {
-            uint32_t start_chunk = msg.params.rto_ms;         // reused for start
-            uint32_t missing_len = msg.params.rtt_alpha_ms;   // reused for length
-            std::cout << "[SR][Sender] Received SR_NACK start=" << start_chunk
-                      << " len=" << missing_len << std::endl;
+            std::cout << "[SR][Sender] Received SR_NACK start=" << msg.nack_start
+                      << " len=" << msg.nack_len << std::endl;
             stats_.nacks_sent++;
-            apply_bitmap(msg);
-            uint32_t cum_chunk = msg.params.max_inflight;
-            if (cum_chunk != UINT32_MAX && cum_chunk + 1 > ack_base_) {
-                ack_base_ = cum_chunk + 1;
-            }
-            if (cum_chunk != UINT32_MAX) {
-                for (uint32_t c = 0; c <= cum_chunk && c < total_chunks_; ++c) {
-                    chunk_acked_[c] = true;
-                }
-            }
+            apply_feedback(msg);
             // retransmit missing chunks based on bitmap state, throttled
             // walk reported gaps
             uint32_t gap_limit = 8;
             uint32_t sent = 0;
+            auto now = std::chrono::steady_clock::now();
+            const int64_t guard_us = rtt_.in_flight_us();
             for (uint16_t i = 0; i < msg.num_gaps && sent < gap_limit; ++i) {
                 uint32_t gs = msg.gap_start[i];
                 uint32_t gl = msg.gap_len[i];
-                uint32_t endc = std::min<uint32_t>(gs + gl, total_chunks_);
+                uint32_t endc = std::min<uint32_t>(gs + gl, next_chunk_to_send_);
                 for (uint32_t c = gs; c < endc && sent < gap_limit; ++c) {
                     if (chunk_acked_[c]) continue;
-                    auto now = std::chrono::steady_clock::now();
-                    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_tx_[c]).count();
-                    if (elapsed < static_cast<long>(guard_ms)) continue; // recently retransmitted
+                    if (elapsed_us(c, now) < guard_us) continue; // recently (re)transmitted
                     retransmit_range(c, 1);
                     sent++;
                 }
             }
-            retransmit_missing_from_bitmap(4);
-            while (next_chunk_to_send_ < total_chunks_ &&
-                   next_chunk_to_send_ < ack_base_ + max_inflight_) {
-                if (!chunk_acked_[next_chunk_to_send_]) {
-                    retransmit_range(next_chunk_to_send_, 1);
-                }
-                next_chunk_to_send_++;
-            }
+            sent += retransmit_missing_from_bitmap(4);
+            fb.lost_chunks = sent;
+            apply_congestion_control(fb);
+            advance_window();
+            check_rto();
         } else if (msg.msg_type == ControlMsgType::COMPLETE_ACK) {
             std::cout << "[SR][Sender] COMPLETE_ACK\n";
             stats_.acks_sent++;
@@ -242,9 +376,8 @@ int SRSender::poll() {
         } else if (msg.msg_type == ControlMsgType::INCOMPLETE_NACK) {
             return -1;
         } else {
-            // Unknown message; check completion and continue
-            int rc = sdr_send_poll(send_handle_.get());
-            if (rc == 0) return 0;
+            std::cerr << "[SR][Sender] Skipping unexpected control message type "
+                      << static_cast<int>(msg.msg_type) << std::endl;
         }
     }
 }
@@ -258,17 +391,69 @@ int SRReceiver::post_receive(SDRConnection* conn, void* buffer, size_t length) {
         return rc;
     }
     recv_handle_.reset(raw_handle);
+    completed_seen_ = 0;
+    progress_time_ = std::chrono::steady_clock::now();
+    fragment_word_ = 0;
     return 0;
 }
 
+// Windows past the ACK's go out ahead of it, a few per tick, rotating through the
+// chunks up to the last one received so the sender's view covers the whole message.
+// Windows with nothing received say nothing the sender does not know and are skipped.
+void SRReceiver::send_bitmap_fragments(const ControlMessage& tick, uint32_t first_word) {
+    uint32_t last = bitmap::find_last_set(chunk_words_.data(), tick.total_chunks);
+    if (last >= tick.total_chunks || last / 64 < first_word) {
+        return;
+    }
+    const uint32_t end_word = last / 64 + 1;
+    if (fragment_word_ < first_word || fragment_word_ >= end_word) {
+        fragment_word_ = first_word;
+    }
+
+    ControlMessage fragment{};
+    fragment.magic = ControlMessage::MAGIC_VALUE;
+    fragment.msg_type = ControlMsgType::SR_BITMAP;
+    fragment.connection_id = tick.connection_id;
+    fragment.total_chunks = tick.total_chunks;
+    fragment.acked_prefix = tick.acked_prefix;
+    uint32_t sent = 0;
+    for (uint32_t scanned = 0; scanned < end_word - first_word && sent < cfg_.bitmap_fragments;) {
+        uint32_t start = fragment_word_;
+        uint32_t count = std::min<uint32_t>(end_word - start, BITMAP_WINDOW_WORDS);
+        scanned += count;
+        fragment_word_ = start + count < end_word ? start + count : first_word;
+        if (bitmap::find_first_set(&chunk_words_[start], count * 64) >= count * 64) {
+            continue;
+        }
+        fragment.bitmap_base = start * 64;
+        fragment.chunk_bitmap_words = static_cast<uint16_t>(count);
+        std::copy_n(chunk_words_.begin() + start, count, fragment.chunk_bitmap);
+        conn_->tcp_server->send_message(fragment);
+        sent++;
+    }
+    stats_.bitmap_fragments_sent += sent;
+}
+
 bool SRReceiver::pump() {
     if (!recv_handle_ || !conn_ || !conn_->tcp_server) {
         return false;
     }
     static auto last_ctrl = std::chrono::steady_clock::now();
     auto now = std::chrono::steady_clock::now();
+
+    // Note when completion last advanced so feedback can report how stale it is
+    auto* progress_ctx = recv_handle_->msg_ctx.get();
+    if (progress_ctx && progress_ctx->frontend_bitmap) {
+        uint32_t completed = progress_ctx->frontend_bitmap->get_total_chunks_completed();
+        if (completed != completed_seen_) {
+            completed_seen_ = completed;
+            progress_time_ = now;
+        }
+    }
+
     auto ctrl_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - last_ctrl).count();
-    uint32_t ctrl_interval = cfg_.nack_delay_ms ? cfg_.nack_delay_ms : std::max<uint32_t>(cfg_.base_rtt_ms / 2, 50u);
+    // Feedback is a few dozen bytes on the wire, so the default tick is a quarter RTT
+    uint32_t ctrl_interval = cfg_.nack_delay_ms ? cfg_.nack_delay_ms : std::max<uint32_t>(cfg_.base_rtt_ms / 4, 10u);
     if (ctrl_elapsed < static_cast<long>(ctrl_interval)) {
         return false; // limit control emission rate
     }
@@ -283,72 +468,53 @@ bool SRReceiver::pump() {
     if (!ctx || !ctx->frontend_bitmap) return false;
     uint32_t total_chunks = ctx->total_chunks;
 
-    // Compute cumulative ack (highest contiguous chunk), allow none-complete case
-    int64_t cumulative_idx = -1;
-    while (static_cast<uint32_t>(cumulative_idx + 1) < total_chunks &&
-           ctx->frontend_bitmap->is_chunk_complete(static_cast<uint32_t>(cumulative_idx + 1))) {
-        cumulative_idx++;
-    }
-    uint32_t cumulative = (cumulative_idx >= 0) ? static_cast<uint32_t>(cumulative_idx) : UINT32_MAX;
-
-    // Build chunk bitmap snapshot (up to 8 words -> 512 chunks)
-    uint64_t words[8] = {0,0,0,0,0,0,0,0};
-    uint32_t word_count = (total_chunks + 63) / 64;
-    if (word_count > 8) word_count = 8;
-    for (uint32_t c = 0; c < total_chunks && c < 512; ++c) {
-        if (ctx->frontend_bitmap->is_chunk_complete(c)) {
-            uint32_t w = c / 64;
-            uint32_t b = c % 64;
-            if (w < 8) words[w] |= (1ULL << b);
-        }
-    }
+    // One snapshot of the chunk bitmap, one pass for the cumulative ACK and the gaps
+    chunk_words_.resize((total_chunks + 63) / 64);
+    uint32_t copied = ctx->frontend_bitmap->snapshot_chunk_bitmap(chunk_words_.data(), static_cast<uint32_t>(chunk_words_.size()));
+    std::fill(chunk_words_.begin() + copied, chunk_words_.end(), 0);
+    bitmap::Gap gaps[4];
+    size_t gaps_found = bitmap::extract_gaps(chunk_words_.data(), total_chunks, gaps, 4);
 
-    // Find first gap from start (no cap; sender will throttle retransmits)
-    uint32_t missing_start = 0;
-    uint32_t missing_len = 0;
-    for (uint32_t c = 0; c < total_chunks; ++c) {
-        if (!ctx->frontend_bitmap->is_chunk_complete(c)) {
-            missing_start = c;
-            // count run of missing
-            uint32_t run = 0;
-            while (c < total_chunks && !ctx->frontend_bitmap->is_chunk_complete(c)) {
-                ++run; ++c;
-            }
-            missing_len = run;
-            break;
-        }
-    }
+    // Cumulative ack: chunks in the complete prefix
+    uint32_t prefix = gaps_found ? gaps[0].start : total_chunks;
+
+    // Bitmap window sent with the ACK, anchored at the word holding the first
+    // missing chunk (up to 16 words -> 1024 chunks)
+    const uint32_t words = static_cast<uint32_t>(chunk_words_.size());
+    uint32_t base_word = std::min(prefix / 64, words);
+    uint32_t word_count = std::min<uint32_t>(words - base_word, BITMAP_WINDOW_WORDS);
+
+    // First gap from start (no cap; sender will throttle retransmits)
+    uint32_t missing_start = gaps_found ? gaps[0].start : 0;
+    uint32_t missing_len = gaps_found ? gaps[0].len : 0;
 
     ControlMessage msg{};
     msg.magic = ControlMessage::MAGIC_VALUE;
     msg.connection_id = conn_->connection_ctx->get_connection_id();
-    msg.params.total_chunks = static_cast<uint16_t>(total_chunks);
-    msg.params.max_inflight = cumulative;
-    msg.chunk_bitmap_words = static_cast<uint16_t>(word_count);
-    for (uint32_t i = 0; i < word_count; ++i) {
-        msg.chunk_bitmap[i] = words[i];
+    msg.total_chunks = total_chunks;
+    msg.acked_prefix = prefix;
+    if (completed_seen_ > 0) {
+        auto held_us = std::chrono::duration_cast<std::chrono::microseconds>(now - progress_time_).count();
+        msg.ack_delay_us = static_cast<uint32_t>(std::min<int64_t>(held_us, UINT32_MAX));
     }
+    msg.bitmap_base = base_word * 64;
+    msg.chunk_bitmap_words = static_cast<uint16_t>(word_count);
+    std::copy_n(chunk_words_.begin() + base_word, word_count, msg.chunk_bitmap);
     // Encode up to 4 gaps from start of window
-    msg.num_gaps = 0;
-    uint16_t gaps_found = 0;
-    for (uint32_t c = 0; c < total_chunks && gaps_found < 4; ++c) {
-        if (!ctx->frontend_bitmap->is_chunk_complete(c)) {
-            uint16_t start = static_cast<uint16_t>(c);
-            uint16_t len = 0;
-            while (c < total_chunks && !ctx->frontend_bitmap->is_chunk_complete(c) && len < UINT16_MAX) {
-                ++len; ++c;
-            }
-            msg.gap_start[gaps_found] = start;
-            msg.gap_len[gaps_found] = len;
-            gaps_found++;
-        }
+    for (size_t i = 0; i < gaps_found; ++i) {
+        msg.gap_start[i] = gaps[i].start;
+        msg.gap_len[i] = gaps[i].len;
+    }
+    msg.num_gaps = static_cast<uint16_t>(gaps_found);
+
+    if (prefix < total_chunks && cfg_.bitmap_fragments > 0) {
+        send_bitmap_fragments(msg, base_word + word_count);
     }
-    msg.num_gaps = gaps_found;
 
     if (missing_len > 0) {
         msg.msg_type = ControlMsgType::SR_NACK;
-        msg.params.rto_ms = missing_start;        // reuse for start chunk
-        msg.params.rtt_alpha_ms = missing_len;    // reuse for length
+        msg.nack_start = missing_start;
+        msg.nack_len = missing_len;
         conn_->tcp_server->send_message(msg);
         std::cout << "[SR][Receiver] NACK start=" << missing_start
                   << " len=" << missing_len << std::endl;
@@ -364,7 +530,7 @@ bool SRReceiver::pump() {
         } else {
             msg.msg_type = ControlMsgType::SR_ACK;
             conn_->tcp_server->send_message(msg);
-            std::cout << "[SR][Receiver] ACK cum=" << cumulative << std::endl;
+            std::cout << "[SR][Receiver] ACK prefix=" << prefix << std::endl;
             stats_.acks_sent++;
         }
     }
@@ -2,6 +2,8 @@
 
 #include "sdr_api.h"
 #include "tcp_control.h"
+#include "reliability/cc.h"
+#include "reliability/rtt_estimator.h"
 #include <cstdint>
 #include <memory>
 #include <vector>
@@ -10,17 +12,62 @@
 namespace sdr::reliability {
 
 struct SRConfig {
-    uint32_t rto_ms{0};            // Base RTO (RTT + alpha*RTT)
+    uint32_t rto_ms{0};            // Initial RTO until the first RTT sample (0 = base_rtt_ms + alpha_ms)
+    uint32_t min_rto_ms{1};        // Bounds for the adaptive RTO
+    uint32_t max_rto_ms{10000};
     uint32_t nack_delay_ms{0};     // Delay before emitting NACK
     uint16_t max_inflight_chunks{0};
     uint32_t base_rtt_ms{100};     // Estimated RTT
     uint32_t alpha_ms{100};        // RTT margin
+    CCAlgorithm cc{CCAlgorithm::NONE};   // Sender congestion control (NONE = fixed window)
+    uint32_t initial_cwnd_chunks{10};
+    uint16_t bitmap_fragments{4};  // SR_BITMAP windows per feedback tick past the ACK's window (0 = none)
+};
+
+// Log2-bucketed latency histogram: bucket i counts values in [2^i, 2^(i+1)) us
+struct SRHistogram {
+    static constexpr size_t BUCKETS = 32;
+    uint64_t counts[BUCKETS]{};
+    uint64_t total{0};
+
+    void record(uint32_t us);
+    static uint32_t bucket_floor_us(size_t i) { return i ? (1u << i) : 0; }
+    // Upper bound of the bucket holding the p-th percentile (0 < p <= 100)
+    uint32_t percentile_us(double p) const;
+};
+
+// Congestion state after one feedback message (sender side)
+struct SRCCSample {
+    uint32_t time_ms;              // Since start_send
+    uint32_t rtt_us;               // 0 if the message yielded no valid sample
+    uint32_t cwnd_chunks;
+    uint64_t pacing_rate;          // bytes/s, 0 = unpaced
 };
 
 struct SRStats {
     uint64_t acks_sent{0};
     uint64_t nacks_sent{0};
     uint64_t retransmits{0};
+    uint64_t packets_retransmitted{0};   // Packets re-sent (SDRSendHandle::packets_sent counts first sends)
+    uint64_t bitmap_fragments_sent{0};   // SR_BITMAP messages (receiver side)
+
+    // Congestion control (sender side)
+    uint32_t cwnd_chunks{0};
+    uint64_t pacing_rate{0};
+    uint64_t rtt_samples{0};
+    uint32_t last_rtt_us{0};
+    uint32_t min_rtt_us{0};
+    uint32_t srtt_us{0};
+    std::vector<SRCCSample> cc_trace;   // First MAX_CC_TRACE feedback messages
+
+    // Retransmission timeout (sender side)
+    uint32_t rttvar_us{0};
+    uint32_t rto_us{0};
+    uint64_t rto_timeouts{0};      // Timer expiries (each backs off the RTO)
+    SRHistogram rtt_hist;          // Every RTT sample
+    SRHistogram rto_hist;          // RTO after every sample or backoff
+
+    static constexpr size_t MAX_CC_TRACE = 4096;
 };
 
 // Sender-side SR controller
@@ -44,16 +91,24 @@ private:
     uint16_t packets_per_chunk_{0};
     uint32_t ack_base_{0};
     uint32_t next_chunk_to_send_{0};
-    uint16_t max_inflight_{0};
+    uint32_t max_inflight_{0};
     std::vector<bool> chunk_acked_;
+    std::vector<uint8_t> tx_count_;     // Transmissions per chunk, saturating (Karn's rule)
     std::vector<std::chrono::steady_clock::time_point> last_tx_;
+    std::chrono::steady_clock::time_point start_time_{};
+    std::unique_ptr<CongestionController> cc_;
+    RttEstimator rtt_{RttEstimator::Config{}};
     std::chrono::steady_clock::time_point last_control_tx_{};
     std::unique_ptr<SDRSendHandle, void(*)(SDRSendHandle*)> send_handle_{nullptr, [](SDRSendHandle* h){ delete h; }};
     SDRConnection* conn_{nullptr};
 
     // Internal helpers would go here (timer management, retransmit queue, etc.).
-    void send_packets_range(uint32_t start_packet, uint32_t packet_count);
+    size_t send_packets_range(uint32_t start_packet, uint32_t packet_count);
     void retransmit_range(uint32_t start_chunk, uint32_t count);
+    uint32_t send_window() const;
+    void apply_congestion_control(const CCFeedback& fb);
+    void sync_pacing_rate();
+    void record_rto();
 };
 
 // Receiver-side SR controller
@@ -73,8 +128,14 @@ public:
 private:
     SRConfig cfg_;
     SRStats stats_{};
+    uint32_t completed_seen_{0};
+    std::chrono::steady_clock::time_point progress_time_{};   // When completed_seen_ last grew
+    std::vector<uint64_t> chunk_words_;   // Chunk bitmap snapshot feedback is built from
+    uint32_t fragment_word_{0};           // Where the next SR_BITMAP window starts
     std::unique_ptr<SDRRecvHandle, void(*)(SDRRecvHandle*)> recv_handle_{nullptr, [](SDRRecvHandle* h){ delete h; }};
     SDRConnection* conn_{nullptr};
+
+    void send_bitmap_fragments(const ControlMessage& tick, uint32_t first_word);
 };
 
 } // namespace sdr::reliability
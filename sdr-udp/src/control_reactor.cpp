@@ -0,0 +1,483 @@
+#include "control_reactor.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+namespace sdr {
+
+namespace {
+constexpr int MAX_EVENTS = 64;
+constexpr int MAX_READS_PER_WAKEUP = 16;      // Per socket, so one busy peer cannot starve the rest
+constexpr size_t READ_SIZE = 4096;            // Bytes per recv; many small frames arrive per read
+} // namespace
+
+// ControlReactor implementation
+std::shared_ptr<ControlReactor> ControlReactor::acquire() {
+    // Kept for the life of the process: the last reference to a channel can be
+    // dropped on the loop thread, which must never end up destroying the loop
+    static std::shared_ptr<ControlReactor> shared = std::make_shared<ControlReactor>();
+    return shared;
+}
+
+ControlReactor::ControlReactor()
+    : epoll_fd_(-1), wake_fd_(-1), timer_fd_(-1), stop_(false), dispatching_fd_(-1), next_timer_id_(1) {
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd_ < 0 || timer_fd_ < 0) {
+        std::cerr << "[Control Reactor] Failed to create event fds: " << strerror(errno) << std::endl;
+        if (epoll_fd >= 0) close(epoll_fd);
+        return;
+    }
+
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd_, &ev);
+    ev.data.fd = timer_fd_;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, timer_fd_, &ev);
+
+    epoll_fd_ = epoll_fd;
+    loop_thread_ = std::thread(&ControlReactor::loop, this);
+}
+
+ControlReactor::~ControlReactor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    if (wake_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t rc = write(wake_fd_, &one, sizeof(one));
+        (void)rc;
+    }
+    if (loop_thread_.joinable()) {
+        loop_thread_.join();
+    }
+    if (epoll_fd_ >= 0) close(epoll_fd_);
+    if (wake_fd_ >= 0) close(wake_fd_);
+    if (timer_fd_ >= 0) close(timer_fd_);
+}
+
+bool ControlReactor::add_socket(int fd, MessageHandler on_message, CloseHandler on_close) {
+    if (epoll_fd_ < 0 || fd < 0) {
+        return false;
+    }
+    auto sock = std::make_shared<Socket>();
+    sock->on_message = std::move(on_message);
+    sock->on_close = std::move(on_close);
+    sock->partial.reserve(READ_SIZE);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    sockets_[fd] = sock;
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLRDHUP;
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        std::cerr << "[Control Reactor] Failed to watch socket " << fd << ": " << strerror(errno) << std::endl;
+        sockets_.erase(fd);
+        return false;
+    }
+    return true;
+}
+
+void ControlReactor::remove_socket(int fd) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto it = sockets_.find(fd);
+    if (it == sockets_.end()) {
+        return;
+    }
+    it->second->removed.store(true);
+    sockets_.erase(it);
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    // From a callback on the loop thread the dispatch is our own caller; elsewhere
+    // wait for a running dispatch of this socket to finish
+    if (!on_loop_thread()) {
+        dispatch_cv_.wait(lock, [&] { return dispatching_fd_ != fd; });
+    }
+}
+
+uint64_t ControlReactor::schedule(std::chrono::microseconds delay, TimerCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t id = next_timer_id_++;
+    timers_[id] = std::move(callback);
+    timer_heap_.push(Timer{std::chrono::steady_clock::now() + delay, id});
+    if (timer_heap_.top().id == id) {
+        arm_timer_locked();
+    }
+    return id;
+}
+
+void ControlReactor::cancel_timer(uint64_t timer_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    timers_.erase(timer_id); // Its heap entry is skipped when it comes due
+}
+
+void ControlReactor::arm_timer_locked() {
+    struct itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    if (!timer_heap_.empty()) {
+        auto delta = timer_heap_.top().deadline - std::chrono::steady_clock::now();
+        int64_t ns = std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::nanoseconds>(delta).count());
+        spec.it_value.tv_sec = ns / 1000000000;
+        spec.it_value.tv_nsec = ns % 1000000000;
+    }
+    timerfd_settime(timer_fd_, 0, &spec, nullptr);
+}
+
+void ControlReactor::run_due_timers() {
+    std::vector<TimerCallback> due;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        while (!timer_heap_.empty() && timer_heap_.top().deadline <= now) {
+            auto it = timers_.find(timer_heap_.top().id);
+            if (it != timers_.end()) {
+                due.push_back(std::move(it->second));
+                timers_.erase(it);
+            }
+            timer_heap_.pop();
+        }
+        arm_timer_locked();
+    }
+    for (auto& callback : due) {
+        callback();
+    }
+}
+
+void ControlReactor::read_socket(int fd) {
+    std::shared_ptr<Socket> sock;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = sockets_.find(fd);
+        if (it == sockets_.end()) {
+            return;
+        }
+        sock = it->second;
+        dispatching_fd_ = fd;
+    }
+
+    // Frames are variable-length; deliver every complete one after each read
+    bool closed = false;
+    for (int reads = 0; reads < MAX_READS_PER_WAKEUP && !sock->removed.load(); ++reads) {
+        size_t have = sock->partial.size();
+        sock->partial.resize(have + READ_SIZE);
+        ssize_t n = recv(fd, sock->partial.data() + have, READ_SIZE, MSG_DONTWAIT);
+        if (n <= 0) {
+            sock->partial.resize(have);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            if (n < 0) {
+                std::cerr << "[Control Reactor] Recv failed: " << strerror(errno) << std::endl;
+            }
+            closed = true;
+            break;
+        }
+        sock->partial.resize(have + static_cast<size_t>(n));
+
+        size_t offset = 0;
+        while (!sock->removed.load() && sock->partial.size() - offset >= ControlMessage::HEADER_SIZE) {
+            size_t length = ControlMessage::frame_length(sock->partial.data() + offset);
+            if (length == 0) {
+                // No way to find the next frame boundary
+                std::cerr << "[Control Reactor] Bad control frame header, closing socket " << fd << std::endl;
+                closed = true;
+                break;
+            }
+            if (sock->partial.size() - offset < length) {
+                break;
+            }
+            ControlMessage msg;
+            if (msg.deserialize(sock->partial.data() + offset, length)) {
+                sock->on_message(msg);
+            } else {
+                std::cerr << "[Control Reactor] Dropping malformed control message" << std::endl;
+            }
+            offset += length;
+        }
+        sock->partial.erase(sock->partial.begin(), sock->partial.begin() + static_cast<std::ptrdiff_t>(offset));
+        if (closed) {
+            break;
+        }
+    }
+
+    if (closed && !sock->removed.load()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = sockets_.find(fd);
+            if (it != sockets_.end() && it->second == sock) {
+                sock->removed.store(true);
+                sockets_.erase(it);
+                epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+            }
+        }
+        sock->on_close();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    dispatching_fd_ = -1;
+    dispatch_cv_.notify_all();
+}
+
+void ControlReactor::loop() {
+    struct epoll_event events[MAX_EVENTS];
+    while (true) {
+        int n = epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "[Control Reactor] epoll_wait failed: " << strerror(errno) << std::endl;
+            return;
+        }
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wake_fd_) {
+                uint64_t count;
+                ssize_t rc = read(wake_fd_, &count, sizeof(count));
+                (void)rc;
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stop_) {
+                    return;
+                }
+            } else if (fd == timer_fd_) {
+                uint64_t expirations;
+                ssize_t rc = read(timer_fd_, &expirations, sizeof(expirations));
+                (void)rc;
+                run_due_timers();
+            } else {
+                read_socket(fd);
+            }
+        }
+    }
+}
+
+// ControlChannel implementation
+std::shared_ptr<ControlChannel> ControlChannel::attach(std::shared_ptr<ControlReactor> reactor, int fd,
+                                                       const char* log_tag) {
+    if (!reactor || !reactor->is_running()) {
+        return nullptr;
+    }
+    std::shared_ptr<ControlChannel> channel(new ControlChannel(reactor, fd, log_tag));
+    std::weak_ptr<ControlChannel> weak = channel;
+    bool added = reactor->add_socket(
+        fd,
+        [weak](const ControlMessage& msg) {
+            if (auto ch = weak.lock()) ch->deliver(msg);
+        },
+        [weak]() {
+            if (auto ch = weak.lock()) ch->on_close();
+        });
+    if (!added) {
+        return nullptr;
+    }
+    channel->attached_ = true;
+    return channel;
+}
+
+ControlChannel::ControlChannel(std::shared_ptr<ControlReactor> reactor, int fd, const char* log_tag)
+    : reactor_(std::move(reactor)), fd_(fd), log_tag_(log_tag ? log_tag : "[Control]"),
+      next_seq_(0), closed_(false), attached_(false) {
+}
+
+ControlChannel::~ControlChannel() {
+    detach();
+}
+
+void ControlChannel::detach() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!attached_) {
+            return;
+        }
+        attached_ = false;
+    }
+    reactor_->remove_socket(fd_);
+    on_close();
+}
+
+bool ControlChannel::closed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_ && inbox_.empty();
+}
+
+std::future<ControlChannel::Result> ControlChannel::next_of(std::initializer_list<ControlMsgType> types,
+                                                            std::chrono::milliseconds timeout) {
+    uint32_t mask = 0;
+    for (ControlMsgType type : types) {
+        mask |= type_bit(type);
+    }
+    if (mask == 0) {
+        mask = ~0u;
+    }
+
+    std::promise<Result> promise;
+    std::future<Result> future = promise.get_future();
+    std::optional<std::promise<Result>> superseded;
+    uint64_t superseded_timer = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // Queued messages first, discarding other types ahead of the match
+        while (!inbox_.empty()) {
+            ControlMessage msg = inbox_.front();
+            inbox_.pop_front();
+            if (mask & type_bit(msg.msg_type)) {
+                promise.set_value(msg);
+                return future;
+            }
+            std::cerr << log_tag_ << " Skipping unexpected control message type "
+                      << static_cast<int>(msg.msg_type) << std::endl;
+        }
+        if (closed_) {
+            promise.set_value(std::nullopt);
+            return future;
+        }
+        if (pending_) {
+            superseded.emplace(std::move(pending_->promise));
+            superseded_timer = pending_->timer_id;
+        }
+        uint64_t seq = ++next_seq_;
+        pending_.emplace(Expectation{mask, std::move(promise), seq, 0});
+        if (timeout.count() > 0) {
+            std::weak_ptr<ControlChannel> weak = weak_from_this();
+            pending_->timer_id = reactor_->schedule(timeout, [weak, seq]() {
+                if (auto ch = weak.lock()) ch->expire(seq);
+            });
+        }
+    }
+    if (superseded) {
+        if (superseded_timer) reactor_->cancel_timer(superseded_timer);
+        superseded->set_value(std::nullopt);
+    }
+    return future;
+}
+
+bool ControlChannel::receive(ControlMessage& msg, std::chrono::milliseconds timeout) {
+    Result result = next_of({}, timeout).get();
+    if (!result) {
+        return false;
+    }
+    msg = *result;
+    return true;
+}
+
+void ControlChannel::on_message(ControlMsgType type, Handler handler) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (handler) {
+        handlers_[type_bit(type)] = std::move(handler);
+    } else {
+        handlers_.erase(type_bit(type));
+    }
+}
+
+void ControlChannel::note_sent(ControlMsgType type) {
+    ControlMsgType reply;
+    if (type == ControlMsgType::OFFER) {
+        reply = ControlMsgType::CTS;
+    } else if (type == ControlMsgType::CTS) {
+        reply = ControlMsgType::ACCEPT;
+    } else {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    awaiting_reply_[type_bit(reply)] = std::chrono::steady_clock::now();
+}
+
+ControlRttStats ControlChannel::rtt_stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return rtt_;
+}
+
+void ControlChannel::record_reply_locked(ControlMsgType type) {
+    auto it = awaiting_reply_.find(type_bit(type));
+    if (it == awaiting_reply_.end()) {
+        return;
+    }
+    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - it->second).count();
+    awaiting_reply_.erase(it);
+    uint32_t sample = static_cast<uint32_t>(std::min<int64_t>(std::max<int64_t>(us, 0), UINT32_MAX));
+    rtt_.samples++;
+    rtt_.last_us = sample;
+    rtt_.min_us = (rtt_.samples == 1) ? sample : std::min(rtt_.min_us, sample);
+    rtt_.srtt_us = (rtt_.samples == 1)
+                       ? sample
+                       : static_cast<uint32_t>(rtt_.srtt_us + (static_cast<int64_t>(sample) - rtt_.srtt_us) / 8);
+}
+
+void ControlChannel::deliver(const ControlMessage& msg) {
+    Handler handler;
+    std::optional<std::promise<Result>> fulfil;
+    uint64_t timer_id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        record_reply_locked(msg.msg_type);
+        auto it = handlers_.find(type_bit(msg.msg_type));
+        if (it != handlers_.end()) {
+            handler = it->second;
+        } else if (pending_) {
+            if (pending_->type_mask & type_bit(msg.msg_type)) {
+                fulfil.emplace(std::move(pending_->promise));
+                timer_id = pending_->timer_id;
+                pending_.reset();
+            } else {
+                std::cerr << log_tag_ << " Skipping unexpected control message type "
+                          << static_cast<int>(msg.msg_type) << std::endl;
+            }
+        } else {
+            inbox_.push_back(msg);
+        }
+    }
+    if (handler) {
+        handler(msg);
+    }
+    if (fulfil) {
+        if (timer_id) reactor_->cancel_timer(timer_id);
+        fulfil->set_value(msg);
+    }
+}
+
+void ControlChannel::on_close() {
+    std::optional<std::promise<Result>> fulfil;
+    uint64_t timer_id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        if (pending_) {
+            fulfil.emplace(std::move(pending_->promise));
+            timer_id = pending_->timer_id;
+            pending_.reset();
+        }
+    }
+    if (fulfil) {
+        if (timer_id) reactor_->cancel_timer(timer_id);
+        fulfil->set_value(std::nullopt);
+    }
+}
+
+void ControlChannel::expire(uint64_t seq) {
+    std::optional<std::promise<Result>> fulfil;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!pending_ || pending_->seq != seq) {
+            return;
+        }
+        fulfil.emplace(std::move(pending_->promise));
+        pending_.reset();
+    }
+    fulfil->set_value(std::nullopt);
+}
+
+} // namespace sdr
@@ -64,6 +64,34 @@ SDRConnection* sdr_listen(SDRContext* ctx, uint16_t tcp_port) {
     return conn;
 }
 
+SDRConnection* sdr_accept(SDRConnection* listener) {
+    if (!listener || !listener->is_receiver || !listener->tcp_server) {
+        return nullptr;
+    }
+
+    TCPControlServer* session = listener->tcp_server->accept_session();
+    if (!session) {
+        return nullptr;
+    }
+
+    auto* conn = new SDRConnection();
+    conn->parent_ctx = listener->parent_ctx;
+    conn->is_receiver = true;
+    conn->tcp_server = session;
+
+    // Sessions inherit the listener's parameters; they cannot each bind the data
+    // ports, so they always receive through the shared engine
+    uint32_t conn_id = ConnectionIDAllocator::allocate();
+    ConnectionParams params = listener->connection_ctx->get_params();
+    params.rx_shared_engine = 1;
+
+    auto connection_ctx = std::make_shared<ConnectionContext>();
+    connection_ctx->initialize(conn_id, params);
+    conn->connection_ctx = connection_ctx;
+
+    return conn;
+}
+
 SDRConnection* sdr_connect(SDRContext* ctx, const char* server_ip, uint16_t tcp_port) {
     if (!ctx || !server_ip) {
         return nullptr;
@@ -86,6 +114,9 @@ SDRConnection* sdr_connect(SDRContext* ctx, const char* server_ip, uint16_t tcp_
     auto connection_ctx = std::make_shared<ConnectionContext>();
     connection_ctx->initialize(conn_id, params);
     conn->connection_ctx = connection_ctx;
+    conn->udp_sender = std::make_shared<UDPSender>();
+    conn->pacer = std::make_shared<TokenBucket>();
+    conn->udp_sender->set_pacer(conn->pacer);
 
     return conn;
 }
@@ -100,6 +131,10 @@ void sdr_disconnect(SDRConnection* conn) {
         conn->udp_receiver->stop();
         conn->udp_receiver.reset(); // Clear the shared_ptr
     }
+    if (conn->rx_engine) {
+        conn->rx_engine->unregister_connection(conn->connection_ctx->get_connection_id());
+        conn->rx_engine.reset(); // The last connection out stops the engine
+    }
 
     // Stop TCP server
     if (conn->tcp_server) {
@@ -112,6 +147,14 @@ void sdr_disconnect(SDRConnection* conn) {
         conn->tcp_client->disconnect();
     }
 
+    // Stop TX threads and release the data-plane channel sockets
+    if (conn->tx_engine) {
+        conn->tx_engine->stop();
+    }
+    if (conn->udp_sender) {
+        conn->udp_sender->close_channels();
+    }
+
     // Clear connection context
     conn->connection_ctx.reset();
 
@@ -138,22 +181,13 @@ int sdr_recv_post(SDRConnection* conn, void* buffer, size_t length, SDRRecvHandl
         return -1; // Only receiver can post receive
     }
 
-    // Wait for OFFER from sender
-    ControlMessage offer{};
-    while (true) {
-        if (!conn->tcp_server->receive_message(offer)) {
-            // Check if connection is still valid (timeout vs connection closed)
-            if (conn->tcp_server->get_client_fd() < 0) {
-                std::cerr << "[SDR API] Failed to receive OFFER: connection closed" << std::endl;
-                return -1;
-            }
-            // Connection still valid, this is a timeout - retry
-            continue;
-        }
-        if (offer.msg_type == ControlMsgType::OFFER) break;
-        std::cerr << "[SDR API] Skipping unexpected control message type "
-                  << static_cast<int>(offer.msg_type) << std::endl;
+    // Wait for OFFER from sender (stale control messages ahead of it are skipped)
+    std::optional<ControlMessage> offer_msg = conn->tcp_server->expect({ControlMsgType::OFFER}).get();
+    if (!offer_msg) {
+        std::cerr << "[SDR API] Failed to receive OFFER: connection closed" << std::endl;
+        return -1;
     }
+    const ControlMessage& offer = *offer_msg;
 
     // Allocate message ID
     uint32_t msg_id = allocate_msg_id(conn->parent_ctx);
@@ -188,6 +222,71 @@ int sdr_recv_post(SDRConnection* conn, void* buffer, size_t length, SDRRecvHandl
     if (params.transfer_id == 0) {
         params.transfer_id = 1;
     }
+    // Transmit batching and threading are sender-side knobs; echo them back unchanged
+    params.tx_batch_size = offer.params.tx_batch_size;
+    params.tx_threads = offer.params.tx_threads;
+    params.tx_pin_cores = offer.params.tx_pin_cores;
+    // Pace at the lower of the sender's cap and the rate this receiver advertises (0 = no limit)
+    if (offer.params.pacing_rate != 0 &&
+        (params.pacing_rate == 0 || offer.params.pacing_rate < params.pacing_rate)) {
+        params.pacing_rate = offer.params.pacing_rate;
+    }
+    params.pacing_burst = offer.params.pacing_burst;
+    // GSO is granted only if this receiver allows it; GRO is a local receive choice
+    params.udp_offload = (offer.params.udp_offload & params.udp_offload & UDP_OFFLOAD_GSO) |
+                         (params.udp_offload & UDP_OFFLOAD_GRO);
+
+    // The shared engine fixes the ports and ring slot size for every connection it serves
+    if (params.rx_shared_engine) {
+        if (!conn->rx_engine) {
+            conn->rx_engine = RXEngine::acquire();
+            if (!conn->rx_engine->start(params.channel_base_port, params.num_channels, 0, params.rx_batch_size,
+                                        params.mtu_bytes, (params.udp_offload & UDP_OFFLOAD_GRO) != 0) ||
+                !conn->rx_engine->register_connection(conn->connection_ctx)) {
+                std::cerr << "[SDR API] Failed to start shared receive engine" << std::endl;
+                conn->rx_engine.reset();
+                return -1;
+            }
+        }
+        params.channel_base_port = conn->rx_engine->base_port();
+        params.num_channels = std::min<uint16_t>(params.num_channels, conn->rx_engine->num_ports());
+        params.mtu_bytes = static_cast<uint32_t>(std::min<size_t>(params.mtu_bytes, conn->rx_engine->max_payload()));
+    }
+
+    // Data header layout: compact when both sides want it and packets reach this
+    // connection's own channel threads (compact headers carry no conn_id for the
+    // shared engine to route by). Otherwise wide when the message is past the
+    // standard header's 18-bit packet offset or this receiver asks for it.
+    // Packet CRCs live in the 32-byte layouts, so asking for them rules out compact.
+    size_t message_packets = (length + params.mtu_bytes - 1) / params.mtu_bytes;
+    bool needs_wide = message_packets > SDRPacketHeader::MAX_PACKETS;
+    uint32_t offered = offer.params.packet_headers;
+    uint32_t wanted = params.packet_headers;
+    uint32_t crc = offered & wanted & PACKET_HEADER_CRC32C;
+    if ((offered & wanted & PACKET_HEADER_COMPACT) && !params.rx_shared_engine && !crc) {
+        params.packet_headers = PACKET_HEADER_COMPACT;
+    } else if (needs_wide || (wanted & PACKET_HEADER_WIDE)) {
+        params.packet_headers = offered & PACKET_HEADER_WIDE;
+    } else {
+        params.packet_headers = 0;
+    }
+    if ((wanted & PACKET_HEADER_CRC32C) && !crc) {
+        std::cout << "[SDR API] Sender cannot checksum packets, receiving without CRC32C" << std::endl;
+    }
+    if ((needs_wide && params.packet_headers == 0) || message_packets > UINT32_MAX) {
+        std::cerr << "[SDR API] Message of " << message_packets << " packets "
+                  << (params.packet_headers ? "exceeds the 32-bit packet index"
+                                            : "needs wide packet headers, which the sender does not offer")
+                  << std::endl;
+        ControlMessage reject{};
+        reject.magic = ControlMessage::MAGIC_VALUE;
+        reject.msg_type = ControlMsgType::REJECT;
+        reject.connection_id = conn->connection_ctx->get_connection_id();
+        reject.params = params;
+        conn->tcp_server->send_message(reject);
+        return -1;
+    }
+    params.packet_headers |= crc;
 
     // Update connection context with initialized params
     conn->connection_ctx->initialize(conn->connection_ctx->get_connection_id(), params);
@@ -209,6 +308,7 @@ int sdr_recv_post(SDRConnection* conn, void* buffer, size_t length, SDRRecvHandl
     static std::atomic<uint32_t> receiver_generation_counter{1};
     uint32_t generation = receiver_generation_counter.fetch_add(1, std::memory_order_relaxed);
     params.transfer_id = generation;
+    params.msg_id = msg_id;
 
     MessageContext* msg_ctx = conn->connection_ctx->allocate_message_slot(msg_id, generation);
 
@@ -225,6 +325,7 @@ int sdr_recv_post(SDRConnection* conn, void* buffer, size_t length, SDRRecvHandl
     msg_ctx->total_chunks = total_chunks;
     msg_ctx->packets_per_chunk = params.packets_per_chunk;
     msg_ctx->connection_params = params;
+    msg_ctx->packets_corrupt.store(0, std::memory_order_relaxed);
 
     // Create bitmaps
     msg_ctx->backend_bitmap = std::make_shared<BackendBitmap>(
@@ -232,8 +333,11 @@ int sdr_recv_post(SDRConnection* conn, void* buffer, size_t length, SDRRecvHandl
     msg_ctx->frontend_bitmap = std::make_shared<FrontendBitmap>(
         msg_ctx->backend_bitmap, static_cast<uint32_t>(total_chunks));
 
-    // Start frontend polling
-    msg_ctx->frontend_bitmap->start_polling(100); // 100 microsecond polling interval
+    // Chunks complete from the receive path; the rescanning poller is opt-in
+    if (params.rx_completion_poll_us > 0) {
+        msg_ctx->frontend_bitmap->start_polling(params.rx_completion_poll_us);
+    }
+    conn->connection_ctx->activate_message(msg_ctx);
 
     // Create receive handle
     auto* recv_handle = new SDRRecvHandle();
@@ -246,9 +350,11 @@ int sdr_recv_post(SDRConnection* conn, void* buffer, size_t length, SDRRecvHandl
     *handle = recv_handle;
 
     // Start UDP receiver if not already started
-    if (!conn->udp_receiver) {
+    if (!conn->rx_engine && !conn->udp_receiver) {
         conn->udp_receiver = std::make_shared<UDPReceiver>(conn->connection_ctx);
-        if (!conn->udp_receiver->start(params.channel_base_port, params.num_channels)) {
+        if (!conn->udp_receiver->start(params.channel_base_port, params.num_channels,
+                                       params.rx_batch_size, params.rx_direct_placement != 0,
+                                       (params.udp_offload & UDP_OFFLOAD_GRO) != 0)) {
             std::cerr << "[SDR API] Failed to start UDP receiver" << std::endl;
             return -1;
         }
@@ -272,20 +378,9 @@ int sdr_recv_post(SDRConnection* conn, void* buffer, size_t length, SDRRecvHandl
     }
 
     // Wait for ACCEPT from sender
-    ControlMessage accept{};
-    while (true) {
-        if (!conn->tcp_server->receive_message(accept)) {
-            // Check if connection is still valid (timeout vs connection closed)
-            if (conn->tcp_server->get_client_fd() < 0) {
-                std::cerr << "[SDR API] Failed to receive ACCEPT: connection closed" << std::endl;
-                return -1;
-            }
-            // Connection still valid, this is a timeout - retry
-            continue;
-        }
-        if (accept.msg_type == ControlMsgType::ACCEPT) break;
-        std::cerr << "[SDR API] Skipping unexpected control message type "
-                  << static_cast<int>(accept.msg_type) << std::endl;
+    if (!conn->tcp_server->expect({ControlMsgType::ACCEPT}).get()) {
+        std::cerr << "[SDR API] Failed to receive ACCEPT: connection closed" << std::endl;
+        return -1;
     }
 
     return 0;
@@ -322,7 +417,7 @@ int sdr_recv_complete(SDRRecvHandle* handle) {
     bool is_complete = false;
     if (handle->msg_ctx) {
         // EC may declare completion explicitly
-        if (handle->msg_ctx->state == MessageState::COMPLETED) {
+        if (handle->msg_ctx->state() == MessageState::COMPLETED) {
             is_complete = true;
         } else if (handle->msg_ctx->frontend_bitmap) {
             uint32_t chunks_received = handle->msg_ctx->frontend_bitmap->get_total_chunks_completed();
@@ -335,7 +430,11 @@ int sdr_recv_complete(SDRRecvHandle* handle) {
     if (handle->conn && handle->conn->connection_ctx) {
         handle->conn->connection_ctx->complete_message(handle->msg_id);
     } else {
-        handle->msg_ctx->state = MessageState::DEAD;
+        handle->msg_ctx->close(MessageState::DEAD);
+    }
+    uint64_t corrupt = handle->msg_ctx->packets_corrupt.load(std::memory_order_relaxed);
+    if (corrupt > 0) {
+        std::cout << "[SDR API] Dropped " << corrupt << " packets that failed CRC32C" << std::endl;
     }
 
     // Send completion ACK or NACK to sender
@@ -385,6 +484,8 @@ int sdr_send_post(SDRConnection* conn, const void* buffer, size_t length, SDRSen
     if (desired.num_channels == 0) desired.num_channels = 1;
     desired.udp_server_port = 0;
     std::memset(desired.udp_server_ip, 0, sizeof(desired.udp_server_ip));
+    // Layouts this sender can build and packet CRCs; CTS picks
+    desired.packet_headers = PACKET_HEADER_WIDE | PACKET_HEADER_COMPACT | PACKET_HEADER_CRC32C;
     offer.params = desired;
 
     if (!conn->tcp_client->send_message(offer)) {
@@ -392,22 +493,18 @@ int sdr_send_post(SDRConnection* conn, const void* buffer, size_t length, SDRSen
         return -1;
     }
 
-    ControlMessage cts_msg;
-    // Loop until we get a CTS (skip any stale control messages)
-    while (true) {
-        if (!conn->tcp_client->receive_message(cts_msg)) {
-            // Check if connection is still valid (timeout vs connection closed)
-            if (!conn->tcp_client->is_connected()) {
-                std::cerr << "[SDR API] Failed to receive CTS: connection closed" << std::endl;
-                return -1;
-            }
-            // Connection still valid, this is a timeout - retry
-            continue;
-        }
-        if (cts_msg.msg_type == ControlMsgType::CTS) break;
-        std::cerr << "[SDR API] Skipping unexpected control message type "
-                  << static_cast<int>(cts_msg.msg_type) << std::endl;
+    // Wait for CTS (skip any stale control messages)
+    std::optional<ControlMessage> cts = conn->tcp_client->expect({ControlMsgType::CTS, ControlMsgType::REJECT}).get();
+    if (!cts) {
+        std::cerr << "[SDR API] Failed to receive CTS: connection closed" << std::endl;
+        return -1;
+    }
+    if (cts->msg_type == ControlMsgType::REJECT) {
+        std::cerr << "[SDR API] Receiver rejected the offer" << std::endl;
+        return -1;
     }
+    ControlMessage cts_msg = *cts;
+    ControlRttStats control_rtt = conn->tcp_client->rtt_stats();
 
     conn->connection_ctx->initialize(cts_msg.connection_id, cts_msg.params);
 
@@ -428,7 +525,18 @@ int sdr_send_post(SDRConnection* conn, const void* buffer, size_t length, SDRSen
         return -1;
     }
 
-    uint32_t msg_id = allocate_msg_id(conn->parent_ctx);
+    uint32_t mtu_bytes = cts_msg.params.mtu_bytes;
+    size_t total_packets = (length + mtu_bytes - 1) / mtu_bytes;
+    HeaderFormat format = conn->connection_ctx->header_format();
+    bool checksum = conn->connection_ctx->payload_crc();
+    if (format == HeaderFormat::STANDARD && total_packets > SDRPacketHeader::MAX_PACKETS) {
+        std::cerr << "[SDR API] Error: " << total_packets << " packets exceed the standard header's "
+                  << SDRPacketHeader::MAX_PACKETS << " and CTS did not grant wide headers" << std::endl;
+        return -1;
+    }
+
+    // The receiver picks the slot; with several sessions per context the two sides' counters differ
+    uint32_t msg_id = cts_msg.params.msg_id;
 
     auto* send_handle = new SDRSendHandle();
     send_handle->msg_id = msg_id;
@@ -445,8 +553,6 @@ int sdr_send_post(SDRConnection* conn, const void* buffer, size_t length, SDRSen
         cts_msg.params.udp_server_ip[sizeof(cts_msg.params.udp_server_ip) - 1] = '\0';
     }
 
-    uint32_t mtu_bytes = cts_msg.params.mtu_bytes;
-    size_t total_packets = (length + mtu_bytes - 1) / mtu_bytes;
     size_t expected_total_packets = (cts_msg.params.total_bytes + mtu_bytes - 1) / mtu_bytes;
     if (cts_msg.params.total_bytes != 0 && total_packets != expected_total_packets) {
         std::cerr << "[SDR API] Warning: sender length (" << length << ") does not match receiver expectation ("
@@ -454,90 +560,87 @@ int sdr_send_post(SDRConnection* conn, const void* buffer, size_t length, SDRSen
     }
 
     std::cout << "[SDR API] Sending " << total_packets << " packets (MTU: " << mtu_bytes
-              << ", packets_per_chunk: " << cts_msg.params.packets_per_chunk << ")" << std::endl;
+              << ", packets_per_chunk: " << cts_msg.params.packets_per_chunk
+              << (format == HeaderFormat::WIDE ? ", wide headers"
+                                               : format == HeaderFormat::COMPACT ? ", compact headers" : "")
+              << (checksum ? ", CRC32C" : "")
+              << ", control RTT: " << control_rtt.last_us << " us)" << std::endl;
 
-    const uint8_t* data = static_cast<const uint8_t*>(buffer);
-    int udp_socket = socket(AF_INET, SOCK_DGRAM, 0);
+    uint16_t num_channels = cts_msg.params.num_channels == 0 ? 1 : cts_msg.params.num_channels;
+    uint16_t base_port = cts_msg.params.channel_base_port == 0 ? cts_msg.params.udp_server_port
+                                                               : cts_msg.params.channel_base_port;
 
-    if (udp_socket < 0) {
-        std::cerr << "[SDR API] Failed to create UDP socket: " << strerror(errno) << std::endl;
+    // Channel sockets persist on the connection; reopened only if the destination changes
+    UDPSender& sender = *conn->udp_sender;
+    if (!sender.open_channels(cts_msg.params.udp_server_ip, base_port, num_channels)) {
+        std::cerr << "[SDR API] Failed to open UDP channel sockets to " << cts_msg.params.udp_server_ip
+                  << ": " << strerror(sender.last_error()) << std::endl;
         delete send_handle;
         return -1;
     }
+    sender.set_batch_size(cts_msg.params.tx_batch_size);
+    if (cts_msg.params.udp_offload & UDP_OFFLOAD_GSO) {
+        if (!sender.enable_gso()) {
+            std::cerr << "[SDR API] Warning: UDP_SEGMENT unavailable (" << strerror(sender.last_error())
+                      << "), sending unsegmented" << std::endl;
+        }
+    } else {
+        sender.disable_gso();
+    }
+    sender.builder().set_message(cts_msg.params.transfer_id, msg_id, cts_msg.params.packets_per_chunk,
+                                 mtu_bytes, buffer, length, cts_msg.connection_id, format, checksum);
 
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_port = htons(cts_msg.params.udp_server_port);
+    // Rate from CTS applies to this message and its retransmits
+    conn->pacer->set_rate(cts_msg.params.pacing_rate, cts_msg.params.pacing_burst);
+    sender.set_socket_pacing_rate(cts_msg.params.pacing_rate / num_channels);
 
-    if (inet_pton(AF_INET, cts_msg.params.udp_server_ip, &server_addr.sin_addr) <= 0) {
-        std::cerr << "[SDR API] Failed to convert IP address: " << cts_msg.params.udp_server_ip << std::endl;
-        close(udp_socket);
-        delete send_handle;
-        return -1;
+    // Multi-threaded TX: one thread per channel share, each with its own sockets
+    TXEngine* engine = nullptr;
+    if (cts_msg.params.tx_threads > 1) {
+        if (num_channels < 2) {
+            std::cerr << "[SDR API] Warning: tx_threads needs num_channels > 1, sending from caller thread"
+                      << std::endl;
+        } else {
+            if (!conn->tx_engine) {
+                conn->tx_engine = std::make_shared<TXEngine>();
+            }
+            if (conn->tx_engine->start(cts_msg.params.udp_server_ip, base_port, num_channels,
+                                       cts_msg.params.tx_threads, cts_msg.params.tx_pin_cores != 0)) {
+                conn->tx_engine->configure(cts_msg.params.tx_batch_size, sender.gso_enabled(), conn->pacer);
+                engine = conn->tx_engine.get();
+            } else {
+                std::cerr << "[SDR API] Warning: TX engine failed to start, sending from caller thread"
+                          << std::endl;
+            }
+        }
     }
 
-    uint16_t num_channels = cts_msg.params.num_channels == 0 ? 1 : cts_msg.params.num_channels;
-    uint16_t base_port = cts_msg.params.channel_base_port == 0 ? cts_msg.params.udp_server_port
-                                                               : cts_msg.params.channel_base_port;
-
     std::cout << "[SDR API] Sending to " << cts_msg.params.udp_server_ip
-              << " base port " << base_port << " across " << num_channels << " channel(s)" << std::endl;
+              << " base port " << base_port << " across " << num_channels << " channel(s)"
+              << ", batch " << sender.batch_size() << (sender.gso_enabled() ? ", GSO" : "");
+    if (conn->pacer->enabled()) {
+        std::cout << ", paced at " << conn->pacer->rate() << " B/s";
+    }
+    if (engine) {
+        std::cout << ", " << engine->num_threads() << " TX threads";
+    }
+    std::cout << std::endl;
 
     size_t packets_failed = 0;
     if (conn->connection_ctx->auto_send_data()) {
-        for (size_t i = 0; i < total_packets; ++i) {
-            uint32_t packet_offset = static_cast<uint32_t>(i);
-            size_t remaining = length - (i * mtu_bytes);
-            size_t packet_data_len = std::min(static_cast<size_t>(mtu_bytes), remaining);
-
-            // Ensure packet_data_len doesn't exceed MAX_PAYLOAD_SIZE
-            if (packet_data_len > SDRPacket::MAX_PAYLOAD_SIZE) {
-                packet_data_len = SDRPacket::MAX_PAYLOAD_SIZE;
-            }
-
-            SDRPacket* packet = SDRPacket::create_data_packet(
-                cts_msg.params.transfer_id, msg_id, packet_offset,
-                cts_msg.params.packets_per_chunk,
-                data + (i * mtu_bytes), packet_data_len);
-            if (packet) {
-                packet->header.chunk_seq = packet->header.get_chunk_id();
-            }
-
-            if (!packet) {
-                std::cerr << "[SDR API] Failed to create packet " << i
-                          << " (data_len: " << packet_data_len << ", MAX: "
-                          << SDRPacket::MAX_PAYLOAD_SIZE << ")" << std::endl;
-                packets_failed++;
-                continue;
-            }
-
-            size_t total_packet_size = sizeof(SDRPacketHeader) + packet_data_len;
-
-            packet->header.to_network_order();
-
-            uint16_t channel_port = base_port + static_cast<uint16_t>(i % num_channels);
-            server_addr.sin_port = htons(channel_port);
-            ssize_t sent = sendto(udp_socket, packet, total_packet_size, 0,
-                                  (struct sockaddr*)&server_addr, sizeof(server_addr));
-
-            if (sent > 0) {
-                send_handle->packets_sent++;
-            } else {
-                if (packets_failed < 5) {
-                    std::cerr << "[SDR API] sendto failed for packet " << i
-                              << ": " << strerror(errno) << " (packet_size: "
-                              << total_packet_size << ")" << std::endl;
-                }
-                packets_failed++;
-            }
-
-            SDRPacket::destroy(packet);
-        }
+        size_t sent = engine ? engine->send_range(cts_msg.params.transfer_id, msg_id,
+                                                  cts_msg.params.packets_per_chunk, mtu_bytes, buffer, length,
+                                                  0, static_cast<uint32_t>(total_packets), cts_msg.connection_id,
+                                                  format, checksum)
+                             : sender.send_range(0, static_cast<uint32_t>(total_packets));
+        send_handle->packets_sent += sent;
+        packets_failed = total_packets - sent;
 
         if (packets_failed > 0) {
+            int last_error = engine ? engine->last_error() : sender.last_error();
             std::cerr << "[SDR API] Error: " << packets_failed << " of " << total_packets
-                      << " packets failed to send" << std::endl;
+                      << " packets failed to send (last error: " << strerror(last_error)
+                      << ")" << std::endl;
             if (packets_failed == total_packets) {
                 std::cerr << "[SDR API] All packets failed! Check packet size limits." << std::endl;
             }
@@ -546,7 +649,6 @@ int sdr_send_post(SDRConnection* conn, const void* buffer, size_t length, SDRSen
         }
     }
 
-    close(udp_socket);
     return 0;
 }
 
@@ -555,32 +657,20 @@ int sdr_send_poll(SDRSendHandle* handle) {
         return -1;
     }
     if (handle->conn && handle->conn->tcp_client && handle->conn->tcp_client->is_connected()) {
-        ControlMessage ack_msg;
         std::cout << "[SDR API] Waiting for completion ACK from receiver..." << std::endl;
 
-        while (true) {
-            if (!handle->conn->tcp_client->receive_message(ack_msg)) {
-                // Check if connection is still valid (timeout vs connection closed)
-                if (!handle->conn->tcp_client->is_connected()) {
-                    std::cerr << "[SDR API] Failed to receive completion ACK: connection closed" << std::endl;
-                    return -1;
-                }
-                // Connection still valid, this is a timeout - retry
-                continue;
-            }
-
-            if (ack_msg.msg_type == ControlMsgType::COMPLETE_ACK) {
-                std::cout << "[SDR API] Received completion ACK from receiver - transfer successful!" << std::endl;
-                return 0;
-            } else if (ack_msg.msg_type == ControlMsgType::INCOMPLETE_NACK) {
-                std::cerr << "[SDR API] Received incomplete NACK - receiver did not complete transfer (packet loss or timeout)" << std::endl;
-                return -1;
-            } else {
-                std::cerr << "[SDR API] Expected COMPLETE_ACK or INCOMPLETE_NACK, got message type: "
-                          << static_cast<int>(ack_msg.msg_type) << ", retrying..." << std::endl;
-                continue;
-            }
+        std::optional<ControlMessage> ack_msg = handle->conn->tcp_client->expect(
+            {ControlMsgType::COMPLETE_ACK, ControlMsgType::INCOMPLETE_NACK}).get();
+        if (!ack_msg) {
+            std::cerr << "[SDR API] Failed to receive completion ACK: connection closed" << std::endl;
+            return -1;
         }
+        if (ack_msg->msg_type == ControlMsgType::INCOMPLETE_NACK) {
+            std::cerr << "[SDR API] Received incomplete NACK - receiver did not complete transfer (packet loss or timeout)" << std::endl;
+            return -1;
+        }
+        std::cout << "[SDR API] Received completion ACK from receiver - transfer successful!" << std::endl;
+        return 0;
     }
 
     return 0;
@@ -611,8 +701,19 @@ int sdr_send_stream_start(SDRConnection* conn, const void* buffer, size_t length
 
     conn->connection_ctx->initialize(cts_msg.connection_id, cts_msg.params);
 
+    uint16_t num_channels = cts_msg.params.num_channels == 0 ? 1 : cts_msg.params.num_channels;
+    uint16_t base_port = cts_msg.params.channel_base_port == 0 ? cts_msg.params.udp_server_port
+                                                               : cts_msg.params.channel_base_port;
+    if (!conn->udp_sender->open_channels(cts_msg.params.udp_server_ip, base_port, num_channels)) {
+        std::cerr << "[SDR API] Failed to open UDP channel sockets to " << cts_msg.params.udp_server_ip
+                  << ": " << strerror(conn->udp_sender->last_error()) << std::endl;
+        return -1;
+    }
+    conn->pacer->set_rate(cts_msg.params.pacing_rate, cts_msg.params.pacing_burst);
+    conn->udp_sender->set_socket_pacing_rate(cts_msg.params.pacing_rate / num_channels);
+
     auto* stream_handle = new SDRStreamHandle();
-    stream_handle->msg_id = allocate_msg_id(conn->parent_ctx);
+    stream_handle->msg_id = cts_msg.params.msg_id;
     stream_handle->generation = cts_msg.params.transfer_id;
     stream_handle->connection_ctx = conn->connection_ctx;
     stream_handle->user_buffer = buffer;
@@ -622,13 +723,14 @@ int sdr_send_stream_start(SDRConnection* conn, const void* buffer, size_t length
     stream_handle->total_packets = (length + mtu_bytes - 1) / mtu_bytes;
     stream_handle->packets_sent = 0;
     stream_handle->is_active = true;
+    stream_handle->conn = conn;
 
     *handle = stream_handle;
     return 0;
 }
 
 int sdr_send_stream_continue(SDRStreamHandle* handle, uint32_t offset, size_t length) {
-    if (!handle || !handle->is_active) {
+    if (!handle || !handle->is_active || !handle->conn || !handle->conn->udp_sender) {
         return -1;
     }
 
@@ -638,56 +740,26 @@ int sdr_send_stream_continue(SDRStreamHandle* handle, uint32_t offset, size_t le
     uint32_t start_packet = offset / mtu_bytes;
     uint32_t end_packet = (offset + length + mtu_bytes - 1) / mtu_bytes;
 
-    int udp_socket = socket(AF_INET, SOCK_DGRAM, 0);
-    if (udp_socket < 0) {
+    // Channel sockets were opened by sdr_send_stream_start
+    UDPSender& sender = *handle->conn->udp_sender;
+    if (sender.num_channels() == 0) {
         return -1;
     }
-
-    struct sockaddr_in server_addr;
-    std::memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    uint16_t num_channels = params.num_channels == 0 ? 1 : params.num_channels;
-    uint16_t base_port = params.channel_base_port == 0 ? params.udp_server_port : params.channel_base_port;
-
-    if (inet_pton(AF_INET, params.udp_server_ip, &server_addr.sin_addr) <= 0) {
-        close(udp_socket);
-        return -1;
+    sender.set_batch_size(params.tx_batch_size);
+    if (!(params.udp_offload & UDP_OFFLOAD_GSO) || !sender.enable_gso()) {
+        sender.disable_gso();
     }
+    sender.builder().set_message(params.transfer_id, handle->msg_id, params.packets_per_chunk,
+                                 mtu_bytes, handle->user_buffer, handle->buffer_size,
+                                 handle->connection_ctx->get_connection_id(),
+                                 handle->connection_ctx->header_format(),
+                                 handle->connection_ctx->payload_crc());
 
-    const uint8_t* data = static_cast<const uint8_t*>(handle->user_buffer);
-
-    for (uint32_t i = start_packet; i < end_packet && i < handle->total_packets; ++i) {
-        uint32_t packet_offset = i;
-        size_t packet_data_len = std::min(static_cast<size_t>(mtu_bytes),
-                                          handle->buffer_size - (i * mtu_bytes));
-
-        SDRPacket* packet = SDRPacket::create_data_packet(
-            params.transfer_id, handle->msg_id, packet_offset,
-            params.packets_per_chunk,
-            data + (i * mtu_bytes), packet_data_len);
-
-        if (!packet) {
-            continue;
-        }
-        packet->header.chunk_seq = packet->header.get_chunk_id();
-
-        size_t total_packet_size = sizeof(SDRPacketHeader) + packet_data_len;
-
-        packet->header.to_network_order();
-
-        uint16_t channel_port = base_port + static_cast<uint16_t>(i % num_channels);
-        server_addr.sin_port = htons(channel_port);
-        ssize_t sent = sendto(udp_socket, packet, total_packet_size, 0,
-                              (struct sockaddr*)&server_addr, sizeof(server_addr));
-
-        if (sent > 0) {
-            handle->packets_sent++;
-        }
-
-        SDRPacket::destroy(packet);
+    if (start_packet < handle->total_packets) {
+        uint32_t last_packet = std::min<uint32_t>(end_packet, static_cast<uint32_t>(handle->total_packets));
+        handle->packets_sent += sender.send_range(start_packet, last_packet - start_packet);
     }
 
-    close(udp_socket);
     return 0;
 }
 
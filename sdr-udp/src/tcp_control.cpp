@@ -1,4 +1,6 @@
 #include "tcp_control.h"
+#include "control_reactor.h"
+#include "sdr_bitmap_kernels.h"
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -6,34 +8,483 @@
 #include <cstring>
 #include <cerrno>
 #include <iostream>
-#include <cstring>
+#include <algorithm>
+#include <type_traits>
 
 namespace sdr {
 
-// ControlMessage serialization
+namespace {
+constexpr std::chrono::milliseconds DEFAULT_RECEIVE_TIMEOUT(200);
+
+std::future<std::optional<ControlMessage>> closed_future() {
+    std::promise<std::optional<ControlMessage>> promise;
+    promise.set_value(std::nullopt);
+    return promise.get_future();
+}
+} // namespace
+
+// ControlMessage wire format
+namespace {
+
+// Top-level field tags
+enum WireTag : uint8_t {
+    TAG_CONNECTION_ID = 1,   // varint
+    TAG_PARAMS = 2,          // group of ConnectionParams fields
+    TAG_FEEDBACK = 3,        // group: prefix, totals, ack delay, NACK range, bitmap base
+    TAG_BITMAP_RLE = 4,      // word count, then alternating zero/one run lengths
+    TAG_BITMAP_RAW = 5,      // word count, then 8-byte little-endian words
+    TAG_GAPS = 6,            // count, then (zigzag start delta from previous end, length)
+};
+
+// Inside a group, tags below this carry one varint; tags at or above it carry a
+// varint length and that many bytes
+constexpr uint8_t GROUP_BYTES_TAG = 0x40;
+constexpr uint8_t PARAM_UDP_SERVER_IP = GROUP_BYTES_TAG;
+
+enum FeedbackTag : uint8_t {
+    FEEDBACK_ACKED_PREFIX = 1,
+    FEEDBACK_TOTAL_CHUNKS = 2,
+    FEEDBACK_ACK_DELAY_US = 3,
+    FEEDBACK_NACK_START = 4,
+    FEEDBACK_NACK_LEN = 5,
+    FEEDBACK_BITMAP_BASE = 6,
+};
+
+// Every numeric ConnectionParams field with its group tag
+template <typename Params, typename Fn>
+void visit_params(Params& p, Fn&& fn) {
+    fn(1, p.transfer_id);
+    fn(2, p.total_bytes);
+    fn(3, p.mtu_bytes);
+    fn(4, p.packet_bytes);
+    fn(5, p.chunk_bytes);
+    fn(6, p.packets_per_chunk);
+    fn(7, p.total_chunks);
+    fn(8, p.fec_k);
+    fn(9, p.fec_m);
+    fn(10, p.max_inflight);
+    fn(11, p.rto_ms);
+    fn(12, p.rtt_alpha_ms);
+    fn(13, p.num_channels);
+    fn(14, p.channel_base_port);
+    fn(15, p.tx_batch_size);
+    fn(16, p.rx_batch_size);
+    fn(17, p.rx_direct_placement);
+    fn(18, p.tx_threads);
+    fn(19, p.tx_pin_cores);
+    fn(20, p.udp_offload);
+    fn(21, p.pacing_burst);
+    fn(22, p.rx_completion_poll_us);
+    fn(23, p.rx_shared_engine);
+    fn(24, p.msg_id);
+    fn(25, p.pacing_rate);
+    fn(26, p.udp_server_port);
+    fn(27, p.packet_headers);
+}
+
+bool carries_params(ControlMsgType type) {
+    return type == ControlMsgType::OFFER || type == ControlMsgType::CTS ||
+           type == ControlMsgType::ACCEPT || type == ControlMsgType::REJECT;
+}
+
+bool carries_feedback(ControlMsgType type) {
+    return type != ControlMsgType::INCOMPLETE_NACK && !carries_params(type);
+}
+
+// Bounds-checked appender; overflow is sticky and reported by ok()
+class WireWriter {
+public:
+    WireWriter(uint8_t* buffer, size_t capacity) : buffer_(buffer), capacity_(capacity), size_(0), ok_(true) {}
+
+    void u8(uint8_t value) {
+        if (size_ >= capacity_) {
+            ok_ = false;
+            return;
+        }
+        buffer_[size_++] = value;
+    }
+
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            u8(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        u8(static_cast<uint8_t>(value));
+    }
+
+    void le(uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) {
+            u8(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void bytes(const uint8_t* data, size_t length) {
+        if (size_ + length > capacity_) {
+            ok_ = false;
+            return;
+        }
+        std::memcpy(buffer_ + size_, data, length);
+        size_ += length;
+    }
+
+    // Tag, length and value of a field encoded separately
+    void field(uint8_t tag, const WireWriter& value) {
+        if (!value.ok()) {
+            ok_ = false;
+            return;
+        }
+        u8(tag);
+        varint(value.size());
+        bytes(value.data(), value.size());
+    }
+
+    // Top-level field holding one varint, written in place
+    void varint_field(uint8_t tag, uint64_t value) {
+        size_t length = 1;
+        for (uint64_t rest = value; rest >= 0x80; rest >>= 7) {
+            length++;
+        }
+        u8(tag);
+        varint(length);
+        varint(value);
+    }
+
+    void group_varint(uint8_t tag, uint64_t value) {
+        if (value != 0) {
+            u8(tag);
+            varint(value);
+        }
+    }
+
+    const uint8_t* data() const { return buffer_; }
+    size_t size() const { return size_; }
+    bool ok() const { return ok_; }
+
+private:
+    uint8_t* buffer_;
+    size_t capacity_;
+    size_t size_;
+    bool ok_;
+};
+
+// Bounds-checked cursor; a read past the end is sticky and reported by ok()
+class WireReader {
+public:
+    WireReader(const uint8_t* data, size_t size) : pos_(data), end_(data + size), ok_(true) {}
+
+    bool done() const { return pos_ >= end_; }
+    bool ok() const { return ok_; }
+
+    uint8_t u8() {
+        if (pos_ >= end_) {
+            ok_ = false;
+            return 0;
+        }
+        return *pos_++;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            uint8_t byte = u8();
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        ok_ = false;
+        return 0;
+    }
+
+    uint64_t le(size_t bytes) {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint64_t>(u8()) << (8 * i);
+        }
+        return value;
+    }
+
+    // Sub-reader over the next length bytes
+    WireReader take(size_t length) {
+        if (length > static_cast<size_t>(end_ - pos_)) {
+            ok_ = false;
+            return WireReader(end_, 0);
+        }
+        WireReader sub(pos_, length);
+        pos_ += length;
+        return sub;
+    }
+
+private:
+    const uint8_t* pos_;
+    const uint8_t* end_;
+    bool ok_;
+};
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+// Walk a group: varint_fn(tag, value) for varint entries, bytes_fn(tag, reader, length)
+// for byte entries
+template <typename VarintFn, typename BytesFn>
+bool read_group(WireReader group, VarintFn&& varint_fn, BytesFn&& bytes_fn) {
+    while (!group.done() && group.ok()) {
+        uint8_t tag = group.u8();
+        if (tag < GROUP_BYTES_TAG) {
+            varint_fn(tag, group.varint());
+        } else {
+            size_t length = static_cast<size_t>(group.varint());
+            bytes_fn(tag, group.take(length), length);
+        }
+    }
+    return group.ok();
+}
+
+void write_bitmap(WireWriter& w, const uint64_t* words, uint16_t word_count) {
+    uint32_t nbits = static_cast<uint32_t>(word_count) * 64;
+    // Raw words: one varint and 8 bytes a word. Runs stop once they cannot be shorter.
+    size_t raw_size = 1 + static_cast<size_t>(word_count) * 8;
+    uint8_t rle_buffer[1 + 16 * 8];
+    WireWriter rle(rle_buffer, raw_size);
+    rle.varint(word_count);
+    bool value = false;
+    for (uint32_t pos = 0; pos < nbits && rle.ok();) {
+        uint32_t next = value ? bitmap::find_first_zero(words, nbits, pos)
+                              : bitmap::find_first_set(words, nbits, pos);
+        rle.varint(next - pos);
+        pos = next;
+        value = !value;
+    }
+    if (rle.ok()) {
+        w.field(TAG_BITMAP_RLE, rle);
+        return;
+    }
+    uint8_t raw_buffer[1 + 16 * 8];
+    WireWriter raw(raw_buffer, sizeof(raw_buffer));
+    raw.varint(word_count);
+    for (uint16_t i = 0; i < word_count; ++i) {
+        raw.le(words[i], 8);
+    }
+    w.field(TAG_BITMAP_RAW, raw);
+}
+
+// Set bits [begin, end) a word at a time
+void set_bits(uint64_t* words, uint32_t begin, uint32_t end) {
+    while (begin < end) {
+        uint32_t bit = begin % 64;
+        uint32_t count = std::min<uint32_t>(64 - bit, end - begin);
+        words[begin / 64] |= (count >= 64 ? ~0ULL : ((1ULL << count) - 1)) << bit;
+        begin += count;
+    }
+}
+
+bool read_bitmap_rle(WireReader r, ControlMessage& msg) {
+    uint64_t word_count = r.varint();
+    if (word_count > 16) {
+        return false;
+    }
+    msg.chunk_bitmap_words = static_cast<uint16_t>(word_count);
+    uint32_t nbits = static_cast<uint32_t>(word_count) * 64;
+    bool value = false;
+    for (uint32_t pos = 0; pos < nbits && r.ok();) {
+        uint64_t run = r.varint();
+        if (run > nbits - pos) {
+            return false;
+        }
+        if (value) {
+            set_bits(msg.chunk_bitmap, pos, pos + static_cast<uint32_t>(run));
+        }
+        pos += static_cast<uint32_t>(run);
+        value = !value;
+    }
+    return r.ok();
+}
+
+bool read_bitmap_raw(WireReader r, ControlMessage& msg) {
+    uint64_t word_count = r.varint();
+    if (word_count > 16) {
+        return false;
+    }
+    msg.chunk_bitmap_words = static_cast<uint16_t>(word_count);
+    for (uint64_t i = 0; i < word_count; ++i) {
+        msg.chunk_bitmap[i] = r.le(8);
+    }
+    return r.ok();
+}
+
+} // namespace
+
+size_t ControlMessage::frame_length(const uint8_t* buffer) {
+    uint16_t wire_magic = static_cast<uint16_t>(buffer[0] | (buffer[1] << 8));
+    if (wire_magic != MAGIC_VALUE || buffer[2] != WIRE_VERSION) {
+        return 0;
+    }
+    return HEADER_SIZE + static_cast<size_t>(buffer[4] | (buffer[5] << 8));
+}
+
 size_t ControlMessage::serialize(uint8_t* buffer, size_t buffer_size) const {
-    if (buffer_size < sizeof(ControlMessage)) {
+    if (buffer_size < HEADER_SIZE) {
         return 0;
     }
-    
-    // Use memcpy for proper alignment
-    std::memcpy(buffer, this, sizeof(ControlMessage));
-    return sizeof(ControlMessage);
+    WireWriter w(buffer + HEADER_SIZE, std::min<size_t>(buffer_size, MAX_WIRE_SIZE) - HEADER_SIZE);
+
+    if (connection_id != 0) {
+        w.varint_field(TAG_CONNECTION_ID, connection_id);
+    }
+
+    if (carries_params(msg_type)) {
+        uint8_t group_buffer[MAX_WIRE_SIZE];
+        WireWriter group(group_buffer, sizeof(group_buffer));
+        visit_params(params, [&](uint8_t tag, auto value) { group.group_varint(tag, value); });
+        size_t ip_length = strnlen(params.udp_server_ip, sizeof(params.udp_server_ip));
+        if (ip_length > 0) {
+            group.u8(PARAM_UDP_SERVER_IP);
+            group.varint(ip_length);
+            group.bytes(reinterpret_cast<const uint8_t*>(params.udp_server_ip), ip_length);
+        }
+        if (group.size() > 0) {
+            w.field(TAG_PARAMS, group);
+        }
+    }
+
+    if (carries_feedback(msg_type)) {
+        uint8_t group_buffer[64];
+        WireWriter group(group_buffer, sizeof(group_buffer));
+        group.group_varint(FEEDBACK_ACKED_PREFIX, acked_prefix);
+        group.group_varint(FEEDBACK_TOTAL_CHUNKS, total_chunks);
+        group.group_varint(FEEDBACK_ACK_DELAY_US, ack_delay_us);
+        group.group_varint(FEEDBACK_NACK_START, nack_start);
+        group.group_varint(FEEDBACK_NACK_LEN, nack_len);
+        group.group_varint(FEEDBACK_BITMAP_BASE, bitmap_base);
+        if (group.size() > 0) {
+            w.field(TAG_FEEDBACK, group);
+        }
+
+        uint16_t word_count = std::min<uint16_t>(chunk_bitmap_words, 16);
+        if (word_count > 0) {
+            write_bitmap(w, chunk_bitmap, word_count);
+        }
+
+        uint16_t gap_count = std::min<uint16_t>(num_gaps, 16);
+        if (gap_count > 0) {
+            uint8_t gap_buffer[1 + 16 * 10];
+            WireWriter gaps(gap_buffer, sizeof(gap_buffer));
+            gaps.varint(gap_count);
+            int64_t previous_end = 0;
+            for (uint16_t i = 0; i < gap_count; ++i) {
+                gaps.varint(zigzag(static_cast<int64_t>(gap_start[i]) - previous_end));
+                gaps.varint(gap_len[i]);
+                previous_end = static_cast<int64_t>(gap_start[i]) + gap_len[i];
+            }
+            w.field(TAG_GAPS, gaps);
+        }
+    }
+
+    if (!w.ok()) {
+        return 0;
+    }
+    buffer[0] = static_cast<uint8_t>(MAGIC_VALUE & 0xFF);
+    buffer[1] = static_cast<uint8_t>(MAGIC_VALUE >> 8);
+    buffer[2] = WIRE_VERSION;
+    buffer[3] = static_cast<uint8_t>(msg_type);
+    buffer[4] = static_cast<uint8_t>(w.size() & 0xFF);
+    buffer[5] = static_cast<uint8_t>(w.size() >> 8);
+    return HEADER_SIZE + w.size();
 }
 
 bool ControlMessage::deserialize(const uint8_t* buffer, size_t buffer_size) {
-    if (buffer_size < sizeof(ControlMessage)) {
+    if (buffer_size < HEADER_SIZE) {
         return false;
     }
-    
-    std::memcpy(this, buffer, sizeof(ControlMessage));
-    
-    // Validate magic
-    if (magic != MAGIC_VALUE) {
+    size_t length = frame_length(buffer);
+    if (length == 0 || length > buffer_size) {
         return false;
     }
-    
-    return true;
+
+    *this = ControlMessage{};
+    magic = MAGIC_VALUE;
+    msg_type = static_cast<ControlMsgType>(buffer[3]);
+
+    WireReader r(buffer + HEADER_SIZE, length - HEADER_SIZE);
+    bool valid = true;
+    while (valid && !r.done()) {
+        uint8_t tag = r.u8();
+        size_t field_length = static_cast<size_t>(r.varint());
+        WireReader value = r.take(field_length);
+        if (!r.ok()) {
+            return false;
+        }
+        switch (tag) {
+        case TAG_CONNECTION_ID:
+            connection_id = static_cast<uint32_t>(value.varint());
+            valid = value.ok();
+            break;
+        case TAG_PARAMS: {
+            uint64_t values[GROUP_BYTES_TAG] = {};
+            valid = read_group(value,
+                [&](uint8_t field_tag, uint64_t field_value) { values[field_tag] = field_value; },
+                [&](uint8_t field_tag, WireReader bytes, size_t bytes_length) {
+                    if (field_tag == PARAM_UDP_SERVER_IP) {
+                        size_t copy = std::min(bytes_length, sizeof(params.udp_server_ip) - 1);
+                        for (size_t i = 0; i < copy; ++i) {
+                            params.udp_server_ip[i] = static_cast<char>(bytes.u8());
+                        }
+                    }
+                });
+            visit_params(params, [&](uint8_t param_tag, auto& field) {
+                field = static_cast<std::remove_reference_t<decltype(field)>>(values[param_tag]);
+            });
+            break;
+        }
+        case TAG_FEEDBACK:
+            valid = read_group(value,
+                [&](uint8_t field_tag, uint64_t field_value) {
+                    uint32_t v = static_cast<uint32_t>(field_value);
+                    switch (field_tag) {
+                    case FEEDBACK_ACKED_PREFIX: acked_prefix = v; break;
+                    case FEEDBACK_TOTAL_CHUNKS: total_chunks = v; break;
+                    case FEEDBACK_ACK_DELAY_US: ack_delay_us = v; break;
+                    case FEEDBACK_NACK_START: nack_start = v; break;
+                    case FEEDBACK_NACK_LEN: nack_len = v; break;
+                    case FEEDBACK_BITMAP_BASE: bitmap_base = v; break;
+                    default: break;
+                    }
+                },
+                [](uint8_t, WireReader, size_t) {});
+            break;
+        case TAG_BITMAP_RLE:
+            valid = read_bitmap_rle(value, *this);
+            break;
+        case TAG_BITMAP_RAW:
+            valid = read_bitmap_raw(value, *this);
+            break;
+        case TAG_GAPS: {
+            uint64_t count = value.varint();
+            if (count > 16) {
+                return false;
+            }
+            int64_t previous_end = 0;
+            for (uint64_t i = 0; i < count; ++i) {
+                int64_t start = previous_end + unzigzag(value.varint());
+                uint64_t len = value.varint();
+                gap_start[i] = static_cast<uint32_t>(start);
+                gap_len[i] = static_cast<uint32_t>(len);
+                previous_end = start + static_cast<int64_t>(len);
+            }
+            num_gaps = static_cast<uint16_t>(count);
+            valid = value.ok();
+            break;
+        }
+        default:
+            break; // Newer field: skip
+        }
+    }
+    return valid && r.ok();
 }
 
 // TCPControlServer implementation
@@ -79,8 +530,8 @@ bool TCPControlServer::start_listening(uint16_t port) {
         return false;
     }
     
-    // Listen
-    if (listen(listen_fd_, 1) < 0) {
+    // Listen (the backlog holds senders connecting while earlier sessions are accepted)
+    if (listen(listen_fd_, SOMAXCONN) < 0) {
         std::cerr << "[TCP Server] Listen failed: " << strerror(errno) << std::endl;
         close(listen_fd_);
         listen_fd_ = -1;
@@ -93,71 +544,111 @@ bool TCPControlServer::start_listening(uint16_t port) {
     return true;
 }
 
-bool TCPControlServer::accept_connection() {
-    if (!is_listening_) {
-        return false;
-    }
-    
-    if (client_fd_ >= 0) {
-        close(client_fd_);
-    }
-    
+int TCPControlServer::accept_client() {
     struct sockaddr_in client_addr;
     socklen_t client_len = sizeof(client_addr);
     
     std::cout << "[TCP Server] Waiting for client connection..." << std::endl;
-    client_fd_ = accept(listen_fd_, (struct sockaddr*)&client_addr, &client_len);
+    int fd = accept(listen_fd_, (struct sockaddr*)&client_addr, &client_len);
     
-    if (client_fd_ < 0) {
+    if (fd < 0) {
         std::cerr << "[TCP Server] Accept failed: " << strerror(errno) << std::endl;
-        return false;
+        return -1;
     }
-
-    // Set a short recv timeout so control loops can make progress under loss
-    struct timeval tv;
-    tv.tv_sec = 0;
-    tv.tv_usec = 200000; // 200 ms
-    setsockopt(client_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
     
     char client_ip[INET_ADDRSTRLEN];
     inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
     std::cout << "[TCP Server] Client connected from " << client_ip << ":" 
               << ntohs(client_addr.sin_port) << std::endl;
-    
+    return fd;
+}
+
+bool TCPControlServer::attach_client(int fd) {
+    if (!reactor_) {
+        reactor_ = ControlReactor::acquire();
+    }
+    channel_ = ControlChannel::attach(reactor_, fd, "[TCP Server]");
+    if (!channel_) {
+        std::cerr << "[TCP Server] Failed to register client with the control reactor" << std::endl;
+        close(fd);
+        return false;
+    }
+    client_fd_ = fd;
     return true;
 }
 
-bool TCPControlServer::receive_message(ControlMessage& msg) {
-    if (client_fd_ < 0) {
+bool TCPControlServer::accept_connection() {
+    if (!is_listening_) {
         return false;
     }
     
-    uint8_t buffer[sizeof(ControlMessage)];
-    ssize_t total_received = 0;
+    close_connection();
+    
+    int fd = accept_client();
+    return fd >= 0 && attach_client(fd);
+}
+
+TCPControlServer* TCPControlServer::accept_session() {
+    if (!is_listening_) {
+        return nullptr;
+    }
     
-    // Receive entire message
-    while (total_received < sizeof(ControlMessage)) {
-        ssize_t n = recv(client_fd_, buffer + total_received, 
-                        sizeof(ControlMessage) - total_received, 0);
-        
-        if (n <= 0) {
-            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-                return false; // timeout, not fatal
-            }
-            if (n == 0) {
-                std::cerr << "[TCP Server] Client disconnected" << std::endl;
-            } else {
-                std::cerr << "[TCP Server] Recv failed: " << strerror(errno) << std::endl;
-            }
-            close(client_fd_);
-            client_fd_ = -1;
-            return false;
-        }
-        
-        total_received += n;
+    int fd = accept_client();
+    if (fd < 0) {
+        return nullptr;
     }
     
-    return msg.deserialize(buffer, sizeof(ControlMessage));
+    auto* session = new TCPControlServer();
+    session->listen_port_ = listen_port_;
+    session->reactor_ = reactor_;
+    if (!session->attach_client(fd)) {
+        delete session;
+        return nullptr;
+    }
+    return session;
+}
+
+bool TCPControlServer::receive_message(ControlMessage& msg) {
+    return receive_message(msg, DEFAULT_RECEIVE_TIMEOUT);
+}
+
+bool TCPControlServer::receive_message(ControlMessage& msg, std::chrono::milliseconds timeout) {
+    if (client_fd_ < 0 || !channel_) {
+        return false;
+    }
+    if (channel_->receive(msg, timeout)) {
+        return true;
+    }
+    if (channel_->closed()) {
+        std::cerr << "[TCP Server] Client disconnected" << std::endl;
+        close_connection();
+    }
+    return false; // timeout, not fatal
+}
+
+std::future<std::optional<ControlMessage>> TCPControlServer::expect(std::initializer_list<ControlMsgType> types,
+                                                                    std::chrono::milliseconds timeout) {
+    if (client_fd_ < 0 || !channel_) {
+        return closed_future();
+    }
+    return channel_->next_of(types, timeout);
+}
+
+void TCPControlServer::on_message(ControlMsgType type, ControlHandler handler) {
+    if (channel_) {
+        channel_->on_message(type, std::move(handler));
+    }
+}
+
+int TCPControlServer::get_client_fd() const {
+    if (client_fd_ < 0 || !channel_ || channel_->closed()) {
+        return -1;
+    }
+    return client_fd_;
+}
+
+ControlRttStats TCPControlServer::rtt_stats() const {
+    return channel_ ? channel_->rtt_stats() : ControlRttStats{};
 }
 
 bool TCPControlServer::send_message(const ControlMessage& msg) {
@@ -165,9 +656,16 @@ bool TCPControlServer::send_message(const ControlMessage& msg) {
         return false;
     }
     
-    uint8_t buffer[sizeof(ControlMessage)];
+    uint8_t buffer[ControlMessage::MAX_WIRE_SIZE];
     size_t len = msg.serialize(buffer, sizeof(buffer));
+    if (len == 0) {
+        std::cerr << "[TCP Server] Failed to encode control message type " << static_cast<int>(msg.msg_type) << std::endl;
+        return false;
+    }
     
+    if (channel_) {
+        channel_->note_sent(msg.msg_type);
+    }
     ssize_t sent = send(client_fd_, buffer, len, 0);
     if (sent < 0) {
         std::cerr << "[TCP Server] Send failed: " << strerror(errno) << std::endl;
@@ -183,6 +681,10 @@ bool TCPControlServer::send_message(const ControlMessage& msg) {
 }
 
 void TCPControlServer::close_connection() {
+    if (channel_) {
+        channel_->detach();
+        channel_.reset();
+    }
     if (client_fd_ >= 0) {
         close(client_fd_);
         client_fd_ = -1;
@@ -240,11 +742,16 @@ bool TCPControlClient::connect_to_server(const std::string& server_ip, uint16_t
         socket_fd_ = -1;
         return false;
     }
-    // Set recv timeout for control-plane polling
-    struct timeval tv;
-    tv.tv_sec = 0;
-    tv.tv_usec = 200000; // 200 ms
-    setsockopt(socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    if (!reactor_) {
+        reactor_ = ControlReactor::acquire();
+    }
+    channel_ = ControlChannel::attach(reactor_, socket_fd_, "[TCP Client]");
+    if (!channel_) {
+        std::cerr << "[TCP Client] Failed to register with the control reactor" << std::endl;
+        close(socket_fd_);
+        socket_fd_ = -1;
+        return false;
+    }
     
     is_connected_ = true;
     std::cout << "[TCP Client] Connected successfully" << std::endl;
@@ -256,9 +763,16 @@ bool TCPControlClient::send_message(const ControlMessage& msg) {
         return false;
     }
     
-    uint8_t buffer[sizeof(ControlMessage)];
+    uint8_t buffer[ControlMessage::MAX_WIRE_SIZE];
     size_t len = msg.serialize(buffer, sizeof(buffer));
+    if (len == 0) {
+        std::cerr << "[TCP Client] Failed to encode control message type " << static_cast<int>(msg.msg_type) << std::endl;
+        return false;
+    }
     
+    if (channel_) {
+        channel_->note_sent(msg.msg_type);
+    }
     ssize_t sent = send(socket_fd_, buffer, len, 0);
     if (sent < 0) {
         std::cerr << "[TCP Client] Send failed: " << strerror(errno) << std::endl;
@@ -275,38 +789,50 @@ bool TCPControlClient::send_message(const ControlMessage& msg) {
 }
 
 bool TCPControlClient::receive_message(ControlMessage& msg) {
-    if (!is_connected_) {
+    return receive_message(msg, DEFAULT_RECEIVE_TIMEOUT);
+}
+
+bool TCPControlClient::receive_message(ControlMessage& msg, std::chrono::milliseconds timeout) {
+    if (!is_connected_ || !channel_) {
         return false;
     }
-    
-    uint8_t buffer[sizeof(ControlMessage)];
-    ssize_t total_received = 0;
-    
-    // Receive entire message
-    while (total_received < sizeof(ControlMessage)) {
-        ssize_t n = recv(socket_fd_, buffer + total_received, 
-                        sizeof(ControlMessage) - total_received, 0);
-        
-        if (n <= 0) {
-            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-                return false; // timeout, not fatal
-            }
-            if (n == 0) {
-                std::cerr << "[TCP Client] Server disconnected" << std::endl;
-            } else {
-                std::cerr << "[TCP Client] Recv failed: " << strerror(errno) << std::endl;
-            }
-            is_connected_ = false;
-            return false;
-        }
-        
-        total_received += n;
+    if (channel_->receive(msg, timeout)) {
+        return true;
     }
-    
-    return msg.deserialize(buffer, sizeof(ControlMessage));
+    if (channel_->closed()) {
+        std::cerr << "[TCP Client] Server disconnected" << std::endl;
+        is_connected_ = false;
+    }
+    return false; // timeout, not fatal
+}
+
+std::future<std::optional<ControlMessage>> TCPControlClient::expect(std::initializer_list<ControlMsgType> types,
+                                                                    std::chrono::milliseconds timeout) {
+    if (!is_connected_ || !channel_) {
+        return closed_future();
+    }
+    return channel_->next_of(types, timeout);
+}
+
+void TCPControlClient::on_message(ControlMsgType type, ControlHandler handler) {
+    if (channel_) {
+        channel_->on_message(type, std::move(handler));
+    }
+}
+
+bool TCPControlClient::is_connected() const {
+    return is_connected_ && channel_ && !channel_->closed();
+}
+
+ControlRttStats TCPControlClient::rtt_stats() const {
+    return channel_ ? channel_->rtt_stats() : ControlRttStats{};
 }
 
 void TCPControlClient::disconnect() {
+    if (channel_) {
+        channel_->detach();
+        channel_.reset();
+    }
     if (socket_fd_ >= 0) {
         close(socket_fd_);
         socket_fd_ = -1;